@@ -1,29 +1,43 @@
 #version 330 core
 // 基础模型片段着色器，支持纹理/法线/阴影
+// 特性由程序变体在编译期注入：USE_TEXTURE / USE_TEXTURE_ALPHA / USE_NORMAL_MAP / USE_SHADOW，
+// USE_TEXTURE_ARRAY（仅 piece.vert）按逐实例层号从纹理数组取反照率，
+// SHADOW_KERNEL 选择滤波核（0: 1 点  1: 2x2  2: 3x3  3: 4x4  4: 泊松 12 点）
+#ifndef SHADOW_KERNEL
+#define SHADOW_KERNEL 2
+#endif
 in vec3 vNormal;
 in vec3 vWorldPos;
 in vec2 vUV;
+in vec4 vTint; // 底色 + 透明度（逐绘制或逐实例）
+#ifdef USE_TEXTURE_ARRAY
+flat in float vLayer;
+#endif
 
 out vec4 FragColor;
 
-uniform vec3 lightDir;
-uniform vec3 viewPos;
-uniform vec3 baseColor;
-uniform float alpha;
+// 帧常量（绑定点 0），每帧上传一次
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightDir;
+    float time;
+    vec3 viewPos;
+};
+
+// 材质参数（绑定点 1）
+layout (std140) uniform MaterialData {
+    float roughness;
+    float metalness;
+};
 
-uniform bool useTexture;
 uniform sampler2D albedoMap;
-uniform bool useTextureAlpha;
-
-uniform bool useNormalMap;
+#ifdef USE_TEXTURE_ARRAY
+uniform sampler2DArray albedoArray;
+#endif
 uniform sampler2D normalMap;
-
-uniform bool useShadow;
-uniform sampler2D shadowMap;
-uniform mat4 lightSpaceMatrix;
-
-uniform float roughness;
-uniform float metalness;
+uniform sampler2DShadow shadowMap; // 深度比较模式 + 线性过滤：每次采样即硬件 2x2 PCF
 
 const float PI = 3.14159265;
 
@@ -47,30 +61,59 @@ mat3 cotangentFrame(vec3 N, vec3 p, vec2 uv) {
 
 vec3 getNormal() {
     vec3 N = normalize(vNormal);
-    if (!useNormalMap) return N;
+#ifndef USE_NORMAL_MAP
+    return N;
+#else
     vec3 mapN = texture(normalMap, vUV).xyz * 2.0 - 1.0;
     mat3 TBN = cotangentFrame(N, vWorldPos, vUV);
     return normalize(TBN * mapN);
+#endif
+}
+
+const vec2 POISSON[12] = vec2[](
+    vec2(-0.326, -0.406), vec2(-0.840, -0.074), vec2(-0.696,  0.457),
+    vec2(-0.203,  0.621), vec2( 0.962, -0.195), vec2( 0.473, -0.480),
+    vec2( 0.519,  0.767), vec2( 0.185, -0.893), vec2( 0.507,  0.064),
+    vec2( 0.896,  0.412), vec2(-0.322, -0.933), vec2(-0.792, -0.598)
+);
+
+// n x n 网格采样：间隔一个纹素、以片段为中心
+float shadowGrid(vec3 p, vec2 texelSize, int n) {
+    float lit = 0.0;
+    float c = float(n - 1) * 0.5;
+    for (int x = 0; x < n; ++x) {
+        for (int y = 0; y < n; ++y) {
+            vec2 o = (vec2(x, y) - c) * texelSize;
+            lit += texture(shadowMap, vec3(p.xy + o, p.z));
+        }
+    }
+    return lit / float(n * n);
 }
 
 float shadowFactor(vec3 N) {
-    if (!useShadow) return 0.0;
+#ifndef USE_SHADOW
+    return 0.0;
+#else
     vec4 fragPosLight = lightSpaceMatrix * vec4(vWorldPos, 1.0);
     vec3 projCoords = fragPosLight.xyz / fragPosLight.w;
     projCoords = projCoords * 0.5 + 0.5;
     if (projCoords.z > 1.0) return 0.0;
 
     float bias = max(0.002 * (1.0 - dot(N, normalize(-lightDir))), 0.0005);
-    float shadow = 0.0;
+    vec3 p = vec3(projCoords.xy, projCoords.z - bias);
     vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0));
-    for (int x = -1; x <= 1; ++x) {
-        for (int y = -1; y <= 1; ++y) {
-            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
-            shadow += (projCoords.z - bias > pcfDepth) ? 1.0 : 0.0;
-        }
+
+#if SHADOW_KERNEL == 4
+    float lit = 0.0;
+    for (int i = 0; i < 12; ++i) {
+        lit += texture(shadowMap, vec3(p.xy + POISSON[i] * 1.5 * texelSize, p.z));
     }
-    shadow /= 9.0;
-    return shadow;
+    lit /= 12.0;
+#else
+    float lit = shadowGrid(p, texelSize, SHADOW_KERNEL + 1);
+#endif
+    return 1.0 - lit;
+#endif
 }
 
 void main() {
@@ -84,15 +127,20 @@ void main() {
     float NdotH = max(dot(N, H), 0.0);
     float VdotH = max(dot(V, H), 0.0);
 
-    vec3 albedo = baseColor;
-    if (useTexture) {
-        albedo = texture(albedoMap, vUV).rgb;
-    }
+#ifdef USE_TEXTURE
+    vec4 texel = texture(albedoMap, vUV);
+    vec3 albedo = texel.rgb;
+#elif defined(USE_TEXTURE_ARRAY)
+    vec3 albedo = vLayer >= 0.0 ? texture(albedoArray, vec3(vUV, vLayer)).rgb : vTint.rgb;
+#else
+    vec3 albedo = vTint.rgb;
+#endif
     albedo = toLinear(albedo);
+#if defined(USE_TEXTURE) && defined(USE_TEXTURE_ALPHA)
+    float texAlpha = texel.a;
+#else
     float texAlpha = 1.0;
-    if (useTexture && useTextureAlpha) {
-        texAlpha = texture(albedoMap, vUV).a;
-    }
+#endif
 
     float r = clamp(roughness, 0.04, 1.0);
     float m = clamp(metalness, 0.0, 1.0);
@@ -124,5 +172,5 @@ void main() {
     vec3 color = ambient + (1.0 - shadow) * Lo;
 
     color = toGamma(color);
-    FragColor = vec4(color, alpha * texAlpha);
+    FragColor = vec4(color, vTint.a * texAlpha);
 }
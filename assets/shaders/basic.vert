@@ -3,23 +3,38 @@
 layout (location=0) in vec3 aPos;
 layout (location=1) in vec3 aNormal;
 layout (location=2) in vec2 aUV;
+layout (location=8) in vec3 aPosOffset; // 位置反量化（常量属性）：压缩网格为包围盒最小点与跨度，完整格式为 0 与 1
+layout (location=9) in vec3 aPosScale;
 
 out vec3 vNormal;
 out vec3 vWorldPos;
 out vec2 vUV;
+out vec4 vTint;
+
+// 帧常量（绑定点 0），每帧上传一次
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightDir;
+    float time;
+    vec3 viewPos;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform vec3 baseColor;
+uniform float alpha;
 
 void main() {
-    vec4 wp = model * vec4(aPos, 1.0);
+    vec3 pos = aPosOffset + aPos * aPosScale;
+    vec4 wp = model * vec4(pos, 1.0);
     vWorldPos = wp.xyz;
 
     mat3 nmat = transpose(inverse(mat3(model)));
     vNormal = normalize(nmat * aNormal);
 
     vUV = aUV;
+    vTint = vec4(baseColor, alpha);
 
     gl_Position = projection * view * wp;
 }
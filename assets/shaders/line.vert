@@ -3,9 +3,17 @@
 
 layout(location = 0) in vec3 aPos;
 
+// 帧常量（绑定点 0），每帧上传一次
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightDir;
+    float time;
+    vec3 viewPos;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main() {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
@@ -0,0 +1,41 @@
+#version 330 core
+// 棋子实例化顶点着色器：模型矩阵、颜色与反照率层号来自逐实例属性
+layout (location=0) in vec3 aPos;
+layout (location=1) in vec3 aNormal;
+layout (location=2) in vec2 aUV;
+layout (location=3) in mat4 iModel; // 占用 3..6
+layout (location=7) in vec4 iColor;
+layout (location=8) in vec3 aPosOffset; // 位置反量化，见 basic.vert
+layout (location=9) in vec3 aPosScale;
+layout (location=10) in float iLayer; // 反照率纹理数组层，负数为无
+
+out vec3 vNormal;
+out vec3 vWorldPos;
+out vec2 vUV;
+out vec4 vTint;
+flat out float vLayer;
+
+// 帧常量（绑定点 0），每帧上传一次
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightDir;
+    float time;
+    vec3 viewPos;
+};
+
+void main() {
+    vec3 pos = aPosOffset + aPos * aPosScale;
+    vec4 wp = iModel * vec4(pos, 1.0);
+    vWorldPos = wp.xyz;
+
+    mat3 nmat = transpose(inverse(mat3(iModel)));
+    vNormal = normalize(nmat * aNormal);
+
+    vUV = aUV;
+    vTint = iColor;
+    vLayer = iLayer;
+
+    gl_Position = projection * view * wp;
+}
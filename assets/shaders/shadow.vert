@@ -1,10 +1,21 @@
 #version 330 core
-// 阴影深度顶点着色器
+// 阴影深度顶点着色器（实例化）
 layout (location=0) in vec3 aPos;
+layout (location=3) in mat4 iModel;
+layout (location=8) in vec3 aPosOffset; // 位置反量化，见 basic.vert
+layout (location=9) in vec3 aPosScale;
 
-uniform mat4 model;
-uniform mat4 lightSpaceMatrix;
+// 帧常量（绑定点 0），每帧上传一次
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightDir;
+    float time;
+    vec3 viewPos;
+};
 
 void main() {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    vec3 pos = aPosOffset + aPos * aPosScale;
+    gl_Position = lightSpaceMatrix * iModel * vec4(pos, 1.0);
 }
@@ -1,13 +1,44 @@
 #version 330 core
-// 文字片段着色器
+// 文字片段着色器；定义 USE_SDF 时按距离场重建边缘，并在同一次绘制中合成描边与阴影
 
 in vec2 TexCoords;
+in vec4 TextColor;
+in vec2 ShadowOffset;
+in float ShadowAlpha;
+in float Outline;
 out vec4 FragColor;
 
 uniform sampler2D text;
-uniform vec3 textColor;
+
+#ifdef USE_SDF
+const vec3 EFFECT_COLOR = vec3(0.05);
+
+// 0.5 为轮廓；以屏幕导数决定过渡宽度，任意缩放下边缘都约为一像素
+float coverage(float d, float edge, float aa) {
+    return smoothstep(edge - aa, edge + aa, d);
+}
+#endif
 
 void main() {
+#ifdef USE_SDF
+    float d = texture(text, TexCoords).r;
+    float aa = max(fwidth(d) * 0.75, 1e-4);
+
+    float fill = coverage(d, 0.5, aa);
+    float outline = Outline > 0.0 ? coverage(d, 0.5 - Outline, aa) : 0.0;
+    float shadow = 0.0;
+    if (ShadowAlpha > 0.0) {
+        float ds = texture(text, TexCoords + ShadowOffset).r;
+        shadow = coverage(ds, 0.5 - Outline, aa) * ShadowAlpha;
+    }
+
+    // 自下而上：阴影、描边（同色），再叠加文字本体
+    float under = max(outline, shadow);
+    float a = fill + under * (1.0 - fill);
+    vec3 rgb = a > 0.0 ? (TextColor.rgb * fill + EFFECT_COLOR * under * (1.0 - fill)) / a : TextColor.rgb;
+    FragColor = vec4(rgb, a * TextColor.a);
+#else
     float a = texture(text, TexCoords).r;
-    FragColor = vec4(textColor, a);
+    FragColor = vec4(TextColor.rgb, TextColor.a * a);
+#endif
 }
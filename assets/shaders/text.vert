@@ -1,13 +1,25 @@
 #version 330 core
-// 文字顶点着色器
+// 文字顶点着色器（字形来自图集页，纹理坐标为像素单位）
 
 layout(location = 0) in vec4 vertex; // <vec2 pos, vec2 uv>
+layout(location = 1) in vec4 color;
+layout(location = 2) in vec4 effect; // <vec2 阴影采样偏移, 阴影不透明度, 描边宽度>
 
 out vec2 TexCoords;
+out vec4 TextColor;
+out vec2 ShadowOffset;
+out float ShadowAlpha;
+out float Outline;
 
 uniform mat4 projection;
+uniform sampler2D text;
 
 void main() {
+    vec2 atlasSize = vec2(textureSize(text, 0));
     gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
-    TexCoords = vertex.zw;
+    TexCoords = vertex.zw / atlasSize;
+    TextColor = color;
+    ShadowOffset = effect.xy / atlasSize;
+    ShadowAlpha = effect.z;
+    Outline = effect.w;
 }
@@ -0,0 +1,24 @@
+#version 330 core
+// 界面批处理片段着色器
+
+in vec2 vUV;
+in vec4 vColor;
+in vec2 vMode;
+
+out vec4 FragColor;
+
+uniform sampler2D uiTexture;
+
+// 与 basic.frag 在界面帧常量下（正对光源、Flat 材质）的结果一致：
+// 线性空间中漫反射 + 环境约为 0.881 * albedo，高光约为 0.0084
+const float UI_DIFFUSE = 0.881;
+const float UI_SPECULAR = 0.0084;
+
+void main() {
+    vec4 texel = texture(uiTexture, vUV);
+    vec3 albedo = mix(vColor.rgb, texel.rgb, vMode.x);
+    float alpha = vColor.a * mix(1.0, texel.a, vMode.y);
+
+    vec3 lit = pow(albedo, vec3(2.2)) * UI_DIFFUSE + UI_SPECULAR;
+    FragColor = vec4(pow(lit, vec3(1.0 / 2.2)), alpha);
+}
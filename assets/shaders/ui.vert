@@ -0,0 +1,27 @@
+#version 330 core
+// 界面批处理顶点着色器（像素坐标，投影取自界面帧常量）
+
+layout(location = 0) in vec4 aPosUV; // <vec2 pos, vec2 uv>
+layout(location = 1) in vec4 aColor;
+layout(location = 2) in vec2 aMode;  // <纹理颜色权重, 纹理透明度权重>
+
+// 帧常量（绑定点 0），每帧上传一次
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 lightSpaceMatrix;
+    vec3 lightDir;
+    float time;
+    vec3 viewPos;
+};
+
+out vec2 vUV;
+out vec4 vColor;
+out vec2 vMode;
+
+void main() {
+    gl_Position = projection * vec4(aPosUV.xy, 0.0, 1.0);
+    vUV = aPosUV.zw;
+    vColor = aColor;
+    vMode = aMode;
+}
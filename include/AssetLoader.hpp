@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Model.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 工作线程准备好的模型：文件读取、导入/缓存映射、反照率解码与内容哈希均已完成，只差 GL 上传
+struct LoadedModel {
+    std::string key;   // 调用方标识
+    std::string path;
+    bool ok = false;
+    ModelData data;
+    double workMs = 0.0; // 工作线程上的耗时
+
+    LoadedModel* next = nullptr; // 完成队列链接
+};
+
+// 资源加载线程池：工作线程并行读取与解码，结果经无锁队列交给 GL 线程按预算上传
+class AssetLoader {
+public:
+    AssetLoader() = default;
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    bool start(unsigned threadCount);
+    void stop();
+    bool running() const { return !m_threads.empty(); }
+
+    // 投递一个模型加载任务（任意顺序完成）
+    void submit(const std::string& key, const std::string& path);
+
+    // 取出一个已完成的结果；没有则返回空。只能由单一线程（GL 线程）调用
+    std::unique_ptr<LoadedModel> poll();
+
+    // 已投递但尚未被 poll 取走的任务数
+    size_t outstanding() const { return m_outstanding; }
+
+private:
+    void workerMain();
+    void pushDone(LoadedModel* item);
+    void freeDone();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::unique_ptr<LoadedModel>> m_jobs;
+    bool m_stop = false;
+
+    // 完成队列：工作线程以 CAS 压栈（多生产者），GL 线程一次摘下整条链并翻转为完成顺序
+    std::atomic<LoadedModel*> m_doneHead{nullptr};
+    LoadedModel* m_ready = nullptr; // GL 线程私有
+    size_t m_outstanding = 0;       // GL 线程私有
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 资源包：把 assets/ 下的所有文件合成一个文件，运行时整体映射，按名字二分查找。
+//
+// 布局：PackHeader | PackEntry[count]（按名字字节序排序）| 名字区 | 数据块（各自 PACK_ALIGN 对齐）。
+// 名字是以 '/' 分隔的相对路径（如 "assets/shaders/basic.vert"）。未压缩条目直接指向映射区；
+// 带 ENTRY_LZ4 的条目按 LZ4 块格式存放，读取时整体解压。
+namespace assetpack {
+
+inline constexpr uint32_t PACK_MAGIC = 0x4B505158u; // "XQPK"
+inline constexpr uint32_t PACK_VERSION = 1;
+inline constexpr size_t PACK_ALIGN = 16;
+
+inline constexpr uint32_t ENTRY_LZ4 = 1u << 0;
+
+struct PackHeader {
+    uint32_t magic = PACK_MAGIC;
+    uint32_t version = PACK_VERSION;
+    uint32_t count = 0;
+    uint32_t namesBytes = 0;
+};
+
+struct PackEntry {
+    uint64_t offset = 0;     // 数据块在文件中的偏移
+    uint64_t storedSize = 0; // 数据块字节数（压缩后）
+    uint64_t size = 0;       // 原始字节数
+    int64_t mtime = 0;       // 打包时源文件的修改时间
+    uint32_t nameOffset = 0; // 名字在名字区中的偏移
+    uint32_t nameLength = 0;
+    uint32_t flags = 0;
+    uint32_t reserved = 0;
+};
+
+static_assert(sizeof(PackHeader) == 16, "PackHeader layout");
+static_assert(sizeof(PackEntry) == 48, "PackEntry layout");
+
+// 打包输入
+struct PackInput {
+    std::string name;
+    std::vector<unsigned char> data;
+    int64_t mtime = 0;
+};
+
+// 写出资源包；compress 时只保留至少省下 1/10 的压缩结果。名字重复或写入失败时返回 false 并填写 error
+bool writePack(const std::string& path, std::vector<PackInput> inputs, bool compress, std::string* error = nullptr);
+
+// 只读资源包
+class AssetPack {
+public:
+    // 映射并校验整个文件（头、条目范围、名字顺序）；失败返回 false
+    bool open(const std::string& path);
+    void close();
+
+    bool valid() const { return m_entries != nullptr; }
+    uint32_t count() const { return m_count; }
+    size_t bytes() const { return m_file.size(); }
+
+    const PackEntry* find(std::string_view name) const;
+    std::string_view name(const PackEntry& e) const { return std::string_view(m_names + e.nameOffset, e.nameLength); }
+    const unsigned char* blob(const PackEntry& e) const { return m_file.data() + e.offset; }
+
+private:
+    MappedFile m_file;
+    const PackEntry* m_entries = nullptr;
+    const char* m_names = nullptr;
+    uint32_t m_count = 0;
+};
+
+} // namespace assetpack
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace cfg {
@@ -34,6 +35,29 @@ inline constexpr float BOARD_METALNESS = 0.05f;
 inline constexpr float PIECE_ROUGHNESS = 0.45f;
 inline constexpr float PIECE_METALNESS = 0.05f;
 
+// 阴影贴图默认分辨率与滤波核（可用 --shadow-size / --shadow-kernel 覆盖）
+// 滤波核：pcf1 | pcf4 | pcf9 | pcf16 | poisson（每个采样点都是硬件 2x2 PCF）
+inline constexpr int SHADOW_MAP_SIZE = 2048;
+inline constexpr const char* SHADOW_KERNEL = "pcf9";
+
+// 界面文字使用距离场字形（任意缩放保持清晰，阴影/描边在同一次绘制中完成）；
+// FreeType 早于 2.11 时自动回退为位图字形
+inline constexpr bool TEXT_SDF = true;
+
+// 资源预加载：工作线程读取/导入/解码，GL 线程每帧最多花这么多毫秒上传；
+// 加载期间帧间隔超过 ASSET_HITCH_MS 记为一次卡顿
+inline constexpr double ASSET_UPLOAD_BUDGET_MS = 4.0;
+inline constexpr double ASSET_HITCH_MS = 33.4;
+
+// 纹理流式上传：PBO 环（个数 × 单个容量），每帧最多从 PBO 提交的字节数
+inline constexpr int TEXTURE_STREAM_SLOTS = 8;
+inline constexpr size_t TEXTURE_STREAM_SLOT_BYTES = 1u << 20;
+inline constexpr size_t TEXTURE_UPLOAD_BUDGET_BYTES = 4u << 20;
+
+// 棋子反照率装入一个纹理数组（逐实例层号），几何相同的棋子合并为一次实例化绘制；
+// 尺寸宽高比与其余不同的反照率仍单独绑定
+inline constexpr bool PIECE_ALBEDO_ARRAY = true;
+
 // 你提供的模型：
 // 棋盘模型路径：assets/models/board/board.glb
 // 棋子模型路径：assets/models/pieces/<color>_<type>.glb
@@ -46,6 +70,27 @@ inline const std::string BOARD_MODEL_OBJ = "assets/models/board/board.obj";
 
 inline const std::string PIECES_DIR = "assets/models/pieces";
 
+// 资源包（构建时由 asset_packer 打包 assets/ 生成）；开发构建中包内缺少的文件回退到散文件
+inline const std::string ASSET_PACK = "assets.pak";
+
+// 预处理模型缓存目录（首次导入后自动写入，源文件变化时自动重建）
+inline const std::string MODEL_CACHE_DIR = "cache/models";
+
+// 导入时把误差在界内的网格打包为 16 字节顶点（量化位置、10:10:10:2 法线、半精度 UV）
+inline constexpr bool VERTEX_PACKING = true;
+
+// 导入时为每个网格生成的 LOD 级数（含完整网格）：第 k 级目标三角形数为上一级的 MODEL_LOD_REDUCTION 倍，
+// 几何误差不超过网格最大跨度的 k × MODEL_LOD_MAX_ERROR（先到者为准）；比上一级减少不到 20% 的级别不生成
+inline constexpr int MODEL_LOD_LEVELS = 3;
+inline constexpr float MODEL_LOD_REDUCTION = 0.5f;
+inline constexpr float MODEL_LOD_MAX_ERROR = 0.01f;
+
+// 绘制时按实例选投影误差不超过这么多像素的最粗一级 LOD；阴影通道在此基础上再粗一级
+inline constexpr float LOD_MAX_SCREEN_ERROR_PX = 1.0f;
+
+// 主通道剔除投影直径小于这么多像素的棋子实例（阴影通道不受影响）
+inline constexpr float CULL_MIN_SCREEN_PX = 2.0f;
+
 // UI 文本字体
 inline const std::string FONT_PATH = "assets/fonts/NotoSansSC-Regular.otf";
 // 菜单背景图
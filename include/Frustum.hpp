@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Model.hpp"
+
+#include <glm/glm.hpp>
+
+// 世界空间包围盒（中心 + 半长），由模型包围盒经实例矩阵变换后外包得到
+struct BoxBounds {
+    glm::vec3 center{0.0f};
+    glm::vec3 extent{0.0f};
+};
+
+// 按矩阵变换包围盒：中心直接变换，半长取 |M| 的线性部分作用于原半长（不需要展开 8 个角点）
+BoxBounds transformBounds(const AABB& box, const glm::mat4& M);
+
+// 视锥体：从裁剪矩阵（投影 × 视图）提取的 6 个朝内的平面
+//
+// 平面按分量分开存放，4 个一组用 SSE 同时测试；补齐到 8 个的两个平面恒为真。
+class Frustum {
+public:
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& clip);
+
+    // 包围盒是否与视锥相交（保守：位于两平面交线外侧角落的盒子也可能判为相交）；有 SSE2 时 4 个平面一组测试
+    bool intersects(const BoxBounds& b) const;
+
+    // 逐平面的标量实现：无 SSE2 的平台用它，测试中作为对照，结果与 intersects 逐位一致
+    bool intersectsScalar(const BoxBounds& b) const;
+
+private:
+    alignas(16) float m_nx[8] = {};
+    alignas(16) float m_ny[8] = {};
+    alignas(16) float m_nz[8] = {};
+    alignas(16) float m_d[8] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+};
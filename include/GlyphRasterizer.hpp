@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Vfs.hpp"
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 单个字形的栅格化结果（8 位距离场，128 为轮廓，越大越靠内）
+struct RasterizedGlyph {
+    bool ok = false;
+    glm::ivec2 size{};
+    glm::ivec2 bearing{};
+    unsigned int advance = 0; // 26.6 定点
+    int ascent = 0;           // 轮廓（不含扩散边）的基线以上高度
+    int descent = 0;          // 轮廓的基线以下深度
+    std::vector<unsigned char> pixels; // 紧密排列，行宽 size.x
+};
+
+// 距离场字形生成线程池：每个工作线程独占一份 FT_Library/FT_Face（FreeType 对象不可跨线程共享），
+// 字体数据只读一份，各线程的 FT_Face 共用
+class GlyphRasterizer {
+public:
+    GlyphRasterizer() = default;
+    ~GlyphRasterizer();
+
+    GlyphRasterizer(const GlyphRasterizer&) = delete;
+    GlyphRasterizer& operator=(const GlyphRasterizer&) = delete;
+
+    // 启动工作线程并在各自线程中从 font 创建字体；任一线程失败则全部停止并返回 false
+    bool start(vfs::File font, int pixelSize, int spread, unsigned threadCount);
+    void stop();
+    bool running() const { return !m_threads.empty(); }
+
+    // 并行生成 cps 中全部字形，阻塞至完成；out[i] 对应 cps[i]
+    void rasterize(const std::vector<char32_t>& cps, std::vector<RasterizedGlyph>& out);
+
+    // 当前系统支持距离场渲染（FreeType 2.11 起）
+    static bool supported();
+
+private:
+    void workerMain(int pixelSize, int spread);
+
+    vfs::File m_font; // 工作线程运行期间有效
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const std::vector<char32_t>* m_jobs = nullptr;
+    std::vector<RasterizedGlyph>* m_out = nullptr;
+    size_t m_jobCount = 0;
+    size_t m_next = 0;
+    size_t m_remaining = 0;
+    bool m_stop = false;
+
+    // 启动握手
+    unsigned m_started = 0;
+    unsigned m_failed = 0;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 块格式（无帧头）的压缩与解压：资源包中的文本类条目按此压缩，读取时整体解压
+namespace lz4 {
+
+// 最坏情况下的压缩输出上限
+inline size_t compressBound(size_t n) {
+    return n + n / 255 + 16;
+}
+
+// 贪心哈希匹配；输出超出 capacity 时返回 0，否则返回压缩后的字节数
+size_t compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+
+// 解压到恰好 rawSize 字节；数据损坏或长度不符时返回 false
+bool decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize);
+
+} // namespace lz4
@@ -2,6 +2,8 @@
 
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 // 顶点数据：位置/法线/UV
@@ -11,6 +13,56 @@ struct VertexPN {
     glm::vec2 uv;
 };
 
+// 压缩顶点（16 字节）：位置按网格包围盒量化为 16 位无符号归一化，
+// 法线为 10:10:10:2 有符号归一化（GL_INT_2_10_10_10_REV），UV 为半精度
+struct VertexPacked {
+    uint16_t pos[4]; // xyz，w 为填充
+    uint32_t normal;
+    uint32_t uv;     // 两个 half，x 在低位
+};
+static_assert(sizeof(VertexPacked) == 16, "VertexPacked must be 16 bytes");
+
+// 网格的顶点布局（导入时按网格选择）
+enum class VertexFormat : uint32_t {
+    Full = 0,   // VertexPN
+    Packed = 1, // VertexPacked
+};
+
+// 位置反量化：pos = offset + q * scale（q ∈ [0,1]）；完整格式为 0 与 1
+// 以常量顶点属性传给着色器（这两个位置从不启用数组，绘制前设置当前值）
+struct VertexDequant {
+    glm::vec3 offset{0.0f};
+    glm::vec3 scale{1.0f};
+};
+
+inline constexpr GLuint VERTEX_ATTR_POS_OFFSET = 8;
+inline constexpr GLuint VERTEX_ATTR_POS_SCALE = 9;
+
+inline size_t vertexStride(VertexFormat f) {
+    return f == VertexFormat::Packed ? sizeof(VertexPacked) : sizeof(VertexPN);
+}
+
+// 实例数据：模型矩阵 + 颜色（rgb 为底色，a 为透明度）+ 反照率纹理数组层号
+// 着色器中占用属性位置 3..6（矩阵列）、7（颜色）与 10（层号）
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 color;
+    float layer = -1.0f; // 负数表示不从纹理数组取色
+};
+
+inline constexpr GLuint INSTANCE_ATTR_MODEL = 3;
+inline constexpr GLuint INSTANCE_ATTR_COLOR = 7;
+inline constexpr GLuint INSTANCE_ATTR_LAYER = 10;
+
+// 细节层次：各级共用顶点缓冲，索引依次存放在同一索引缓冲中，0 级为完整网格
+inline constexpr int MAX_MESH_LODS = 3;
+
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f; // 到完整网格表面的均方根距离估计（模型空间单位，0 级为 0）
+};
+
 // 网格封装
 class Mesh {
 public:
@@ -25,8 +77,27 @@ public:
 
     static Mesh fromTriangles(const std::vector<VertexPN>& verts, const std::vector<unsigned int>& indices);
     static Mesh fromTrianglesNonIndexed(const std::vector<VertexPN>& verts);
+    static Mesh fromRaw(const VertexPN* verts, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+    static Mesh fromPacked(const VertexPacked* verts, size_t vertexCount, const VertexDequant& dequant,
+                           const unsigned int* indices, size_t indexCount);
+
+    // 设置 LOD 索引区间（须在索引缓冲范围内，第 0 级应覆盖完整网格）；不设置时只有一级
+    void setLods(const MeshLod* lods, int count);
 
-    void draw() const;
+    // lod 超出范围时取最粗的一级
+    void draw(int lod = 0) const;
+
+    // 实例化绘制：实例属性取自 instanceBuffer 中 byteOffset 起的 count 个 InstanceData
+    void drawInstanced(GLuint instanceBuffer, size_t byteOffset, GLsizei count, int lod = 0) const;
+
+    int lodCount() const { return m_lodCount; }
+    const MeshLod& lod(int i) const { return m_lods[clampLod(i)]; }
+
+    // 顶点缓冲字节数
+    size_t vertexBytes() const { return m_vertexBytes; }
+    // 索引缓冲字节数（含全部 LOD 的索引）
+    size_t indexBytes() const { return m_indexed ? (size_t)m_elemCount * sizeof(unsigned int) : 0; }
+    size_t vertexCount() const { return m_vertexCount; }
 
 private:
     GLuint m_vao = 0;
@@ -34,4 +105,13 @@ private:
     GLuint m_ebo = 0;
     GLsizei m_elemCount = 0;
     bool m_indexed = false;
+    size_t m_vertexCount = 0;
+    size_t m_vertexBytes = 0;
+    VertexDequant m_dequant;
+    MeshLod m_lods[MAX_MESH_LODS];
+    int m_lodCount = 1;
+
+    void bindDequant() const;
+    int clampLod(int i) const { return i < 0 ? 0 : (i < m_lodCount ? i : m_lodCount - 1); }
+    void countDraw(const MeshLod& l, uint64_t instances) const;
 };
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// 导入期网格优化（结果随预处理缓存保存，只在首次导入时运行）
+//
+// 典型顺序：optimizeVertexCache -> optimizeOverdraw -> optimizeVertexFetch，之后可用 simplify 生成 LOD。
+// 索引均为三角形列表，indexCount 须为 3 的倍数。
+namespace meshopt {
+
+// 变换后顶点缓存的模拟容量（FIFO），用于 ACMR 统计与簇划分
+inline constexpr unsigned CACHE_SIZE = 16;
+
+// 平均缓存未命中率：每个三角形需要执行顶点着色器的次数（0.5~3，越低越好）
+float acmr(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize = CACHE_SIZE);
+
+// Forsyth 线性速度顶点缓存排序：按顶点在缓存中的位置与剩余价数打分，贪心输出得分最高的三角形
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// 过度绘制排序：把已按缓存排序的三角形切成簇，外侧朝外的簇先画；
+// 簇边界选在缓存已失效处，ACMR 最多变差 threshold 倍（超出则保持原顺序）
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const VertexPN* vertices, size_t vertexCount,
+                      float threshold = 1.05f);
+
+// 顶点读取排序：顶点按首次被引用的顺序重排并改写索引，丢弃未引用的顶点；返回新的顶点数
+size_t optimizeVertexFetch(VertexPN* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+// 二次误差度量（QEM）简化：把顶点沿边折叠到相邻的已有顶点上，只改写索引，各级 LOD 可共用同一顶点缓冲。
+// 开放边界与属性接缝（同一位置有多个顶点）上的顶点保持不动。三角形数降到 targetIndexCount 以下，
+// 或下一次折叠的误差（到原表面的均方根距离，与顶点坐标同单位）超过 maxError 时停止。
+// destination 至少能容纳 indexCount 个索引（可与 indices 相同）；返回新的索引数，resultError 为达到的误差。
+size_t simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount, const VertexPN* vertices,
+                size_t vertexCount, size_t targetIndexCount, float maxError, float* resultError = nullptr);
+
+} // namespace meshopt
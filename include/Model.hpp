@@ -1,10 +1,15 @@
 #pragma once
 
+#include "MappedFile.hpp"
 #include "Mesh.hpp"
+#include "ResourceManager.hpp"
 #include "Texture.hpp"
+#include "TextureStreamer.hpp"
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 // 轴对齐包围盒
@@ -13,26 +18,98 @@ struct AABB {
     glm::vec3 max;
 };
 
+// 网格数据视图（指向 ModelData 自有的存储或映射的缓存文件）
+struct MeshData {
+    VertexFormat format = VertexFormat::Full;
+    const void* vertices = nullptr; // VertexPN 或 VertexPacked，见 format
+    uint32_t vertexCount = 0;
+    VertexDequant dequant;          // 仅 Packed
+    const uint32_t* indices = nullptr;
+    uint32_t indexCount = 0;            // 各级 LOD 索引的总数
+    MeshLod lods[MAX_MESH_LODS];        // 在 indices 中的区间，0 级为完整网格
+    uint32_t lodCount = 0;              // 0 表示只有完整网格（整个 indices）
+    uint64_t hash = 0;                  // 内容哈希（格式、顶点、索引与 LOD），0 为未计算
+};
+
+// 反照率数据：压缩图片字节（png/jpg，按原样解码）或原始 RGBA 像素
+enum class AlbedoKind : uint32_t {
+    None = 0,
+    Encoded = 1,
+    Rgba = 2,
+};
+
+struct AlbedoData {
+    AlbedoKind kind = AlbedoKind::None;
+    int width = 0;  // 仅 Rgba
+    int height = 0;
+    const unsigned char* bytes = nullptr;
+    size_t size = 0;
+    uint64_t hash = 0; // 内容哈希（Rgba 含尺寸），0 为未计算
+};
+
+// 模型的 CPU 端数据：已变换到模型空间的顶点、索引、包围盒、建议变换与反照率
+//
+// 数据来自 Assimp 导入（存于各 storage 中）或预处理缓存（指向 file 的映射），不涉及 GL 调用。
+struct ModelData {
+    std::vector<MeshData> meshes;
+    AABB aabb{{0,0,0},{0,0,0}};
+    glm::mat4 suggested{1.0f};
+    AlbedoData albedo;
+
+    MappedFile file;
+    std::vector<VertexPN> vertexStorage;
+    std::vector<VertexPacked> packedStorage;
+    std::vector<uint32_t> indexStorage;
+    std::vector<unsigned char> albedoStorage;
+};
+
 // 模型加载与绘制
 class Model {
 public:
     Model() = default;
+
+    // 优先读取预处理缓存，缺失或过期时用 Assimp 导入并写回缓存
     explicit Model(const std::string& path);
 
+    // 从已加载的 CPU 数据创建 GL 资源。给出 resources 时网格与反照率按内容哈希与其他模型共享，
+    // 反照率经其 streamer 分帧上传，驻留前按无纹理绘制
+    explicit Model(const ModelData& data, ResourceManager* resources = nullptr);
+
+    // 读取模型数据（缓存或导入），不涉及 GL 调用
+    static bool loadData(const std::string& path, ModelData& out);
+
+    // 在当前线程把压缩的反照率解码为 RGBA，之后 GL 线程只需上传像素；解码失败时去掉反照率
+    static bool decodeAlbedo(ModelData& data);
+
+    // 计算各网格与反照率的内容哈希（可在工作线程调用；已计算的跳过）
+    static void hashContent(ModelData& data);
+
     bool valid() const { return !m_meshes.empty(); }
-    void draw() const;
+    void draw(int lod = 0) const;
+    void drawInstanced(GLuint instanceBuffer, size_t byteOffset, GLsizei count, int lod = 0) const;
+
+    // LOD 级数（各网格中最多的级数，网格级数不足时用其最粗一级）与该级的最大几何误差（模型空间）
+    int lodCount() const { return m_lodCount; }
+    float lodError(int lod) const;
 
     const AABB& aabb() const { return m_aabb; }
 
+    // 显存中的顶点字节数与顶点数（用于统计打包节省）
+    size_t vertexBytes() const;
+    size_t vertexCount() const;
+
     // Renderer 使用的访问接口
     bool hasAlbedo() const { return m_albedo.valid(); }
     GLuint albedoId() const { return m_albedo.id(); }
+    // 替换反照率（反照率改由纹理数组提供时，无法装入的图像单独建纹理后交回模型）
+    void setAlbedo(TextureRef albedo) { m_albedo = std::move(albedo); }
     const glm::mat4& suggestedTransform() const { return m_suggested; }
 
 private:
-    std::vector<Mesh> m_meshes;
+    std::vector<MeshRef> m_meshes;
+    int m_lodCount = 1;
     AABB m_aabb{{0,0,0},{0,0,0}};
 
-    Texture2D m_albedo;
+    TextureRef m_albedo;
     glm::mat4 m_suggested{1.0f};
 };
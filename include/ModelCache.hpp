@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Model.hpp"
+
+#include <string>
+
+// 预处理模型缓存（.xqm）：一次 Assimp 导入的结果按二进制原样保存，之后启动直接映射读取
+//
+// 文件布局（小端，各段按 16 字节对齐）：
+//   ModelCacheHeader
+//   ModelCacheMesh[meshCount]
+//   顶点段（VertexPN[] 或 VertexPacked[]，按网格记录）、索引段 uint32[]（各网格依次排列，网格内各级 LOD 相接）
+//   反照率段（压缩图片字节或 RGBA 像素）
+// 头中记录源文件的大小、修改时间与内容哈希：大小与时间一致直接使用；
+// 时间变化但哈希一致（如重新检出）仍视为有效。
+namespace modelcache {
+
+// 源文件对应的缓存路径（cfg::MODEL_CACHE_DIR 下）
+std::string cachePath(const std::string& sourcePath);
+
+// 校验并映射缓存；成功时 out 中的网格与反照率指向映射内存
+bool load(const std::string& sourcePath, ModelData& out);
+
+// 写出缓存（先写临时文件再改名，避免留下半个文件）
+bool write(const std::string& sourcePath, const ModelData& data);
+
+} // namespace modelcache
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Mesh;
+class Model;
+
+// 渲染通道（执行顺序即枚举顺序）
+enum class RenderPass : uint8_t {
+    Shadow,     // 阴影深度（离屏）
+    Background, // 全屏背景，按提交顺序
+    Scene,      // 场景：不透明按状态/前后排序，半透明按远到近排序
+    Overlay,    // 文字与界面，按提交顺序
+    Count,
+};
+
+// 混合方式
+enum class BlendMode : uint8_t {
+    Alpha,    // SRC_ALPHA, ONE_MINUS_SRC_ALPHA
+    Additive, // SRC_ALPHA, ONE
+};
+
+// 面剔除方式
+enum class CullMode : uint8_t {
+    None,
+    Back,
+    Front,
+};
+
+// 绘制命令所需的固定管线状态；执行时只在与上一条命令不同时切换
+struct RenderState {
+    uint8_t shader = 0;
+    uint32_t texture = 0; // 单元 0 上的纹理
+    BlendMode blend = BlendMode::Alpha;
+    bool depthTest = true;
+    bool depthWrite = true;
+    CullMode cull = CullMode::None;
+};
+
+// 命令类型
+enum class RenderCommandKind : uint8_t {
+    Mesh,      // 单个网格，transform + color
+    Model,     // 模型的全部网格，transform + color
+    Instanced, // 模型实例化批次 [first, first+count)，payload 为 LOD 级别
+    Lines,     // 线段网格（调用方私有的顶点数组）
+    Text,      // 文字（payload 为调用方文字表中的下标）
+    UiRect,    // 屏幕空间矩形，transform 为矩形变换，payload 为纹理
+};
+
+// 绘制命令记录：状态 + 少量载荷，由执行器解释
+struct RenderCommand {
+    RenderCommandKind kind = RenderCommandKind::Mesh;
+    RenderState state;
+    uint8_t material = 0; // 材质预设
+    uint8_t flags = 0;    // 执行器自定义开关
+    const Mesh* mesh = nullptr;
+    const Model* model = nullptr;
+    glm::mat4 transform = glm::mat4(1.0f);
+    glm::vec4 color = glm::vec4(1.0f);
+    size_t first = 0;
+    uint32_t count = 0;
+    uint32_t payload = 0;
+};
+
+// 执行器接口：RenderQueue 只通过它改变状态与发出绘制，便于在无 GPU 时计数验证
+class RenderExecutor {
+public:
+    virtual ~RenderExecutor() = default;
+
+    virtual void beginPass(RenderPass pass) = 0;
+    virtual void endPass(RenderPass pass) = 0;
+    virtual void setShader(uint8_t shader) = 0;
+    virtual void setTexture(uint32_t texture) = 0;
+    virtual void setBlend(BlendMode blend) = 0;
+    virtual void setDepth(bool test, bool write) = 0;
+    virtual void setCull(CullMode cull) = 0;
+    virtual void draw(const RenderCommand& cmd) = 0;
+};
+
+// 执行时实际发生的状态切换次数
+struct RenderQueueStats {
+    uint32_t commands = 0;
+    uint32_t passChanges = 0;
+    uint32_t shaderChanges = 0;
+    uint32_t textureChanges = 0;
+    uint32_t blendChanges = 0;
+    uint32_t depthChanges = 0;
+    uint32_t cullChanges = 0;
+};
+
+// 排序键（64 位，高位优先）：
+//   [63..61] 通道  [60] 半透明
+//   不透明：[59..52] 着色器 [51..36] 纹理 [35..12] 深度（近到远） [11..0] 序号
+//   半透明：[59..36] 深度（远到近） [35..28] 着色器 [27..12] 纹理 [11..0] 序号
+//   按提交顺序的通道（Background/Overlay）：[47..0] 序号
+namespace sortkey {
+
+inline constexpr int PASS_SHIFT = 61;
+inline constexpr int TRANSLUCENT_SHIFT = 60;
+inline constexpr uint32_t DEPTH_BITS = 24;
+inline constexpr uint32_t SEQUENCE_BITS = 12;
+
+// 深度 [0,1] 量化为 24 位
+uint32_t quantizeDepth(float depth01);
+
+uint64_t make(RenderPass pass, bool translucent, uint8_t shader, uint32_t texture, float depth01, uint32_t sequence);
+uint64_t makeOrdered(RenderPass pass, uint32_t sequence);
+
+inline RenderPass pass(uint64_t key) { return (RenderPass)(key >> PASS_SHIFT); }
+
+} // namespace sortkey
+
+// 渲染队列：每帧提交、按键基数排序、顺序执行并剔除冗余状态切换
+class RenderQueue {
+public:
+    void clear();
+
+    // 按状态/深度排序的提交；depth01 为归一化视深度（0 为最近）
+    void submit(RenderPass pass, bool translucent, float depth01, const RenderCommand& cmd);
+
+    // 按提交顺序执行的提交（背景/界面）
+    void submitOrdered(RenderPass pass, const RenderCommand& cmd);
+
+    // LSD 基数排序（每趟 8 位，跳过所有键在该字节上相同的趟）
+    void sort();
+
+    // 按排序结果执行；返回实际的状态切换统计
+    RenderQueueStats execute(RenderExecutor& exec) const;
+
+    size_t size() const { return m_commands.size(); }
+    uint64_t keyAt(size_t sortedIndex) const { return m_keys[m_order[sortedIndex]]; }
+    const RenderCommand& commandAt(size_t sortedIndex) const { return m_commands[m_order[sortedIndex]]; }
+
+private:
+    std::vector<RenderCommand> m_commands;
+    std::vector<uint64_t> m_keys;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_scratch;
+    uint32_t m_sequence = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+// 全局绘制计数：各处发出绘制调用时累加，Renderer 每帧清零并汇总
+struct DrawCounters {
+    uint64_t drawCalls = 0;
+    uint64_t triangles = 0;
+    uint64_t lodTrianglesSaved = 0; // 因使用较粗 LOD 少提交的三角形数
+    uint64_t vertexBytes = 0; // 绘制引用的顶点缓冲字节数（实例化按实例数计）
+};
+
+inline DrawCounters& drawCounters() {
+    static DrawCounters counters;
+    return counters;
+}
+
+// 每帧渲染统计（由 Renderer 在每帧开始时清零）
+struct RenderStats {
+    uint32_t drawCalls = 0;      // glDraw* 调用次数
+    uint32_t triangles = 0;      // 提交的三角形数（含实例）
+    uint32_t trianglesLod0 = 0;  // 同样的绘制全部使用完整网格时的三角形数（与 triangles 之差为 LOD 节省）
+    uint32_t vertexKB = 0;       // 顶点读取量估计：各次绘制的顶点缓冲大小之和（KB）
+    uint32_t pieceInstances = 0; // 主通道棋子实例数
+    uint32_t pieceBatches = 0;   // 主通道棋子实例化绘制数（不含光晕）
+    uint32_t culledFrustum = 0;  // 主通道：视锥外而剔除的实例
+    uint32_t culledSmall = 0;    // 主通道：投影过小而剔除的实例
+    uint32_t shadowCasters = 0;  // 阴影通道绘制的实例
+    uint32_t shadowCulled = 0;   // 阴影通道：光源视锥外而剔除的实例
+    uint32_t queueCommands = 0;  // 渲染队列执行的命令数
+    uint32_t shaderChanges = 0;  // 队列执行中的程序切换
+    uint32_t textureChanges = 0; // 队列执行中的纹理切换
+    uint32_t stateChanges = 0;   // 队列执行中的混合/深度/剔除切换
+    uint32_t shadowPasses = 0;   // 本帧是否重画阴影贴图（0/1）
+    uint32_t shadowPassesPerSec = 0; // 最近一秒（模拟时间）的阴影重画次数
+    uint32_t uniformUploads = 0; // 实际发出的 glUniform* 调用
+    uint32_t uniformSkipped = 0; // 值未变化而跳过的上传
+    uint32_t uniformLookups = 0; // 按名字查表的设置调用
+    uint32_t textLayoutHits = 0;   // 文字排版缓存命中
+    uint32_t textLayoutMisses = 0; // 需要解码并重新排版的文字
+    uint32_t uiQuads = 0;   // 界面批处理的矩形数
+    uint32_t uiBatches = 0; // 界面批处理发出的绘制
+    uint32_t textureUploadBytes = 0; // 上一次流式上传提交的纹理字节数
+    uint32_t texturesPending = 0;    // 尚未驻留的异步纹理
+    uint32_t gpuTextureKB = 0; // 资源管理器估计的纹理显存（含纹理数组）
+    uint32_t gpuMeshKB = 0;    // 资源管理器估计的顶点与索引缓冲显存
+
+    // 按 (名称, 数值) 遍历全部计数，供日志/CSV 输出
+    template <typename F>
+    void forEach(F&& f) const {
+        f("draw_calls", drawCalls);
+        f("triangles", triangles);
+        f("triangles_lod0", trianglesLod0);
+        f("vertex_kb", vertexKB);
+        f("piece_instances", pieceInstances);
+        f("piece_batches", pieceBatches);
+        f("culled_frustum", culledFrustum);
+        f("culled_small", culledSmall);
+        f("shadow_casters", shadowCasters);
+        f("shadow_culled", shadowCulled);
+        f("queue_commands", queueCommands);
+        f("shader_changes", shaderChanges);
+        f("texture_changes", textureChanges);
+        f("state_changes", stateChanges);
+        f("shadow_passes", shadowPasses);
+        f("shadow_passes_per_sec", shadowPassesPerSec);
+        f("uniform_uploads", uniformUploads);
+        f("uniform_skipped", uniformSkipped);
+        f("uniform_lookups", uniformLookups);
+        f("text_layout_hits", textLayoutHits);
+        f("text_layout_misses", textLayoutMisses);
+        f("ui_quads", uiQuads);
+        f("ui_batches", uiBatches);
+        f("texture_upload_bytes", textureUploadBytes);
+        f("textures_pending", texturesPending);
+        f("gpu_texture_kb", gpuTextureKB);
+        f("gpu_mesh_kb", gpuMeshKB);
+    }
+};
@@ -1,64 +1,216 @@
 #pragma once
 
+#include "AssetLoader.hpp"
 #include "Camera.hpp"
+#include "Config.hpp"
+#include "Frustum.hpp"
 #include "Model.hpp"
 #include "Primitives.hpp"
+#include "RenderQueue.hpp"
+#include "RenderStats.hpp"
+#include "ResourceManager.hpp"
 #include "Shader.hpp"
 #include "Texture.hpp"
 #include "TextRenderer.hpp"
+#include "TextureArrayPacker.hpp"
+#include "TextureStreamer.hpp"
+#include "UiBatch.hpp"
+#include "UniformBuffer.hpp"
 #include "XiangqiGame.hpp"
 
 #include <glm/glm.hpp>
 
+#include <array>
+#include <chrono>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
-// UI 矩形区域
-struct UiRect {
-    float x = 0.0f;
-    float y = 0.0f;
-    float w = 0.0f;
-    float h = 0.0f;
-};
-
 // 菜单布局
 struct MenuLayout {
     UiRect start;
     UiRect exit;
 };
 
-// 渲染器
-class Renderer {
+// basic.frag 的编译期特性（ShaderVariants 掩码位，顺序与特性名表一致）
+enum ShaderFeature : uint32_t {
+    FEATURE_TEXTURE = 1u << 0,       // USE_TEXTURE
+    FEATURE_TEXTURE_ALPHA = 1u << 1, // USE_TEXTURE_ALPHA
+    FEATURE_NORMAL_MAP = 1u << 2,    // USE_NORMAL_MAP
+    FEATURE_SHADOW = 1u << 3,        // USE_SHADOW
+};
+inline constexpr uint32_t SHADER_VARIANT_COUNT = 16;
+
+// basic 着色器变量句柄（相机/光照/材质参数在统一缓冲块中，特性开关在编译期确定）
+struct BasicShaderUniforms {
+    Uniform<glm::mat4> model;
+    Uniform<glm::vec3> baseColor;
+    Uniform<float> alpha;
+    Uniform<int> albedoMap;
+    Uniform<int> normalMap;
+    Uniform<int> shadowMap;
+    Uniform<int> albedoArray;
+};
+
+// line 着色器变量句柄
+struct LineShaderUniforms {
+    Uniform<glm::mat4> model;
+    Uniform<glm::vec3> color;
+};
+
+// 材质预设（MaterialData 缓冲中的槽位）
+enum class MaterialPreset {
+    Board,
+    Piece,
+    Flat,  // 无高光：选中标记、光晕（界面在 ui.frag 中按同样结果着色）
+    Count,
+};
+
+// 实例批次：同一模型、同一 LOD 在实例缓冲中的一段连续实例
+struct InstanceBatch {
+    const Model* model = nullptr;
+    size_t first = 0;
+    GLsizei count = 0;
+    int lod = 0;
+    bool layered = false; // 反照率来自纹理数组（逐实例层号）
+};
+
+// 阴影滤波核（与 basic.frag 中 SHADOW_KERNEL 宏的取值一致）
+enum class ShadowKernel : int {
+    Pcf1 = 0,
+    Pcf4 = 1,
+    Pcf9 = 2,
+    Pcf16 = 3,
+    Poisson = 4,
+};
+
+// 解析滤波核名称（pcf1/pcf4/pcf9/pcf16/poisson）
+bool parseShadowKernel(const std::string& name, ShadowKernel& out);
+
+// cfg::SHADOW_KERNEL 对应的滤波核（无法解析时为 Pcf9）
+ShadowKernel defaultShadowKernel();
+
+// 阴影贴图缓存键：光源固定，阴影只取决于棋子的摆放与动画
+struct ShadowCacheKey {
+    uint64_t boardHash = 0;
+    bool animating = false; // 有移动/吃子动画时每帧都要重画
+    int selected = -1;      // 选中格 y*9+x，-1 为无
+    float pulse = 0.0f;     // 选中棋子的呼吸相位（改变其阴影大小与高度）
+    uint64_t lodHash = 0;   // 阴影批次的 LOD（随相机距离变化）
+
+    bool operator==(const ShadowCacheKey& o) const {
+        return boardHash == o.boardHash && animating == o.animating && selected == o.selected && pulse == o.pulse &&
+               lodHash == o.lodHash;
+    }
+};
+
+// 一次预加载的耗时报告（加载完成时写入日志）
+struct AssetLoadReport {
+    uint32_t models = 0;
+    double wallMs = 0.0;      // beginPreload 到全部上传完成
+    double workMs = 0.0;      // 各工作线程耗时之和
+    double uploadMs = 0.0;    // GL 线程上传耗时之和
+    double maxSliceMs = 0.0;  // 单帧最长上传时间
+    double maxFrameMs = 0.0;  // 加载期间最长帧间隔
+    uint32_t frames = 0;      // 加载期间经过的帧数
+    uint32_t hitches = 0;     // 帧间隔超过 cfg::ASSET_HITCH_MS 的帧数
+    size_t vertexBytes = 0;     // 模型顶点显存
+    size_t vertexBytesFull = 0; // 若全部使用 VertexPN 的顶点显存
+};
+
+// 渲染队列中的着色器编号（同时决定不透明物体的状态排序）
+enum class ShaderId : uint8_t {
+    Basic,
+    Piece,
+    PieceArray, // piece.vert + 反照率纹理数组
+    Line,
+    Shadow,
+    Text,
+    Ui,
+};
+
+// 渲染器：每帧把绘制提交到渲染队列，排序后由自身作为执行器翻译为 GL 调用
+class Renderer : private RenderExecutor {
 public:
     bool init(int viewportW, int viewportH);
+    // 销毁 GL 上下文前调用：停止纹理上传线程并释放 PBO 与栅栏
+    void shutdown();
+
+    // 阴影质量：分辨率与滤波核；初始化后调用会重建阴影贴图
+    void setShadowQuality(int size, ShadowKernel kernel);
     void resize(int viewportW, int viewportH);
 
     void draw(const OrbitCamera& cam, const XiangqiGame& game);
     void drawMenu(const MenuLayout& layout, bool hoverStart, bool hoverExit, bool startEnabled);
     void drawLoading(const std::string& message);
+    // 启动工作线程加载棋盘与全部棋子；preloadStep 每帧在预算内上传已就绪的模型
     void beginPreload();
-    bool preloadStep(int maxItems = 1);
+    bool preloadStep(double budgetMs = cfg::ASSET_UPLOAD_BUDGET_MS);
     bool isPreloadReady() const;
+    bool preloadFailed() const { return m_preloadFailed; }
+
+    // 每帧调用：在字节预算内推进异步纹理上传
+    void streamTextures();
+    const AssetLoadReport& loadReport() const { return m_loadReport; }
+
+    // 最近一帧的渲染统计
+    const RenderStats& stats() const { return m_stats; }
+
+    // 纹理与网格的去重与显存统计（预加载完成时自动输出一次）
+    const ResourceManager& resources() const { return m_resources; }
+    void logResourceStats() const { m_resources.logStats(); }
 
 private:
     int m_w = 1;
     int m_h = 1;
 
-    Shader m_basicShader;
     Shader m_lineShader;
     Shader m_shadowShader;
 
+    // basic.frag 程序变体（basic.vert / piece.vert / piece.vert + 纹理数组各一组），句柄按掩码惰性解析
+    ShaderVariants m_basicVariants;
+    ShaderVariants m_pieceVariants;
+    ShaderVariants m_pieceArrayVariants;
+    std::array<BasicShaderUniforms, SHADER_VARIANT_COUNT> m_basicVariantU;
+    std::array<BasicShaderUniforms, SHADER_VARIANT_COUNT> m_pieceVariantU;
+    std::array<BasicShaderUniforms, SHADER_VARIANT_COUNT> m_pieceArrayVariantU;
+    uint32_t m_basicResolved = 0; // 已解析句柄的掩码集合（位 i 对应掩码 i）
+    uint32_t m_pieceResolved = 0;
+    uint32_t m_pieceArrayResolved = 0;
+
+    LineShaderUniforms m_lineU;
+
+    // 帧常量缓冲：[场景][界面] 两段，每帧整体上传一次；材质缓冲初始化时写入
+    UniformBuffer m_frameUbo;
+    UniformBuffer m_materialUbo;
+    std::vector<unsigned char> m_frameStaging;
+    size_t m_uiFrameOffset = 0;
+    size_t m_materialStride = 0;
+
+    RenderStats m_stats;
+
     TextRenderer m_text;
-    Texture2D m_menuBg;
-    Texture2D m_checkOverlay;
-    Texture2D m_redWinOverlay;
-    Texture2D m_blackWinOverlay;
-    Texture2D m_gameBg;
-    Texture2D m_boardNormal;
+    TextureStreamer m_textures;
+    ResourceManager m_resources;
+    bool m_resourcesReported = false;
+    TextureRef m_menuBg;
+    TextureRef m_checkOverlay;
+    TextureRef m_redWinOverlay;
+    TextureRef m_blackWinOverlay;
+    TextureRef m_gameBg;
+    TextureRef m_boardNormal;
     GLuint m_shadowFBO = 0;
     GLuint m_shadowTex = 0;
-    int m_shadowSize = 2048;
+    int m_shadowSize = cfg::SHADOW_MAP_SIZE;
+    ShadowKernel m_shadowKernel = defaultShadowKernel();
+
+    // 阴影缓存：键不变时跳过阴影通道，沿用上一次的深度贴图
+    ShadowCacheKey m_shadowKey;
+    bool m_shadowValid = false;
+    float m_shadowWindowStart = 0.0f;
+    uint32_t m_shadowWindowPasses = 0;
+    uint32_t m_shadowPassesPerSec = 0;
 
     Model m_boardModel;
     bool m_hasBoardModel = false;
@@ -66,19 +218,66 @@ private:
 
     std::unordered_map<std::string, Model> m_pieceModels;
 
+    // 棋子反照率纹理数组：预加载时收集各棋子的反照率，全部模型就绪后装箱并分帧逐层上传。
+    // 几何相同的棋子共用一个绘制模型，实例只靠层号区分，从而合并为一次实例化绘制
+    struct PieceMaterial {
+        const Model* drawModel = nullptr; // 实际绘制的模型（几何相同的棋子中的代表）
+        int layer = -1;                   // 纹理数组层，-1 为无（按阵营底色）
+    };
+    std::unordered_map<const Model*, PieceMaterial> m_pieceMaterials; // 不在表中的模型按自身反照率绘制
+    std::unordered_map<std::string, uint64_t> m_pieceGeometry;       // 本次预加载的棋子键 -> 几何哈希
+    TextureArrayPacker m_albedoPacker;
+    Texture2DArray m_pieceAlbedos;
+    size_t m_albedoUploadNext = 0; // m_albedoPacker 中下一个待上传的图像
+    uint32_t m_albedoUploadBytes = 0;
+    bool m_pieceAlbedosReady = false;
+
     Mesh m_fallbackDisc;
-    Mesh m_uiQuad;
+    UiBatcher m_ui;
 
     // 网格线（即使使用棋盘模型也可绘制）
     GLuint m_lineVAO = 0;
     GLuint m_lineVBO = 0;
     GLsizei m_lineVertexCount = 0;
 
+    // 棋子实例：每帧收集、按模型分组后一次性上传
+    // 实例在哪些通道可见（剔除结果）
+    enum : uint8_t {
+        PIECE_VISIBLE_MAIN = 1 << 0,
+        PIECE_VISIBLE_SHADOW = 1 << 1,
+    };
+    struct PieceItem {
+        const Model* model = nullptr;
+        InstanceData inst;
+        int lod = 0;
+        uint8_t visible = 0; // PIECE_VISIBLE_*
+        bool layered = false;
+    };
+    // 本帧的剔除与 LOD 参数
+    struct PieceView {
+        Frustum camera;
+        Frustum light;
+        glm::vec3 eye{0.0f};
+        float pixelsPerUnit = 0.0f; // 距离 1 处一个世界单位的像素数
+    };
+    PieceItem makePieceItem(const Model* model, const InstanceData& inst, bool castsShadow, const PieceView& view);
+    GLuint m_instanceVBO = 0;
+    size_t m_instanceCapacity = 0;
+    std::vector<PieceItem> m_pieceItems;
+    std::vector<InstanceData> m_instances;
+    std::vector<InstanceBatch> m_opaqueBatches;  // 静止/移动中的棋子
+    std::vector<InstanceBatch> m_shadowBatches;  // 不透明棋子中光源视锥内的部分，LOD 再粗一级
+    std::vector<InstanceBatch> m_glowBatches;    // 选中光晕
+    std::vector<InstanceBatch> m_captureBatches; // 被吃淡出（半透明，最后绘制）
+
     std::string m_boardPath;
     bool m_boardLoaded = false;
     bool m_preloadFailed = false;
-    std::vector<Piece> m_pendingPieces;
-    size_t m_pendingIndex = 0;
+    AssetLoader m_assets;
+    AssetLoadReport m_loadReport;
+    std::chrono::steady_clock::time_point m_loadStart;
+    std::chrono::steady_clock::time_point m_lastPreloadStep;
+    bool m_loadReported = false;
 
     glm::vec3 boardToWorld(const Pos& p) const;
     std::string findBoardModelPath() const;
@@ -87,5 +286,57 @@ private:
     const Model* getPieceModelOrNull(const std::string& key);
     void ensureLineGrid();
 
+    void acceptLoadedModel(LoadedModel& item);
+    void buildPieceMaterials();
+    void uploadPieceAlbedos(size_t budgetBytes);
     void computeBoardModelTransform();
+    void createShadowMap();
+
+    void resolveUniforms();
+    void applyShadowKernel();
+    const BasicShaderUniforms* useVariant(ShaderId id, uint32_t features);
+    void gatherPieceInstances(const XiangqiGame& game, const PieceView& view);
+    int selectLod(const Model* model, float scale, float distance, float pixelsPerUnit) const;
+    void appendBatches(std::vector<InstanceBatch>& out, std::vector<InstanceBatch>* shadowOut = nullptr);
+    ShadowCacheKey makeShadowKey(const XiangqiGame& game) const;
+    void countShadowPass(float timeSec, bool rendered);
+    void uploadInstances();
+    // 渲染队列
+    struct QueuedText {
+        std::string text;
+        float x = 0.0f;
+        float y = 0.0f;
+        float scale = 1.0f;
+        glm::vec3 color = glm::vec3(1.0f);
+        TextEffect effect;
+    };
+    RenderQueue m_queue;
+    std::vector<QueuedText> m_texts; // 按下标复用，避免每帧重新分配字符串
+    size_t m_textCount = 0;
+    bool m_shadowReady = false;
+    ShaderId m_execShader = ShaderId::Basic;
+    const BasicShaderUniforms* m_execU = nullptr;
+    int m_execMaterial = -1;
+
+    void submitUiRect(RenderPass pass, const UiRect& r, const glm::vec3& color, float alpha, GLuint tex = 0, bool texAlpha = false);
+    void submitText(std::string_view text, float x, float y, float scale, const glm::vec3& color,
+                    const TextEffect& effect = TextEffect{});
+    void submitShadowedText(std::string_view text, float x, float y, float scale, const glm::vec3& color);
+    void flushQueue();
+
+    // RenderExecutor
+    void beginPass(RenderPass pass) override;
+    void endPass(RenderPass pass) override;
+    void setShader(uint8_t shader) override;
+    void setTexture(uint32_t texture) override;
+    void setBlend(BlendMode blend) override;
+    void setDepth(bool test, bool write) override;
+    void setCull(CullMode cull) override;
+    void draw(const RenderCommand& cmd) override;
+
+    void initUniformBuffers();
+    void uploadFrameUniforms(const FrameUniforms& scene);
+    void bindSceneFrame();
+    void bindMaterial(MaterialPreset preset);
+    void captureStats();
 };
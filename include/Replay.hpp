@@ -0,0 +1,86 @@
+#pragma once
+
+#include "RenderStats.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 回放脚本事件类型
+enum class ReplayEventType {
+    MouseMove,   // move <x> <y>
+    MouseDown,   // down <left|right>
+    MouseUp,     // up <left|right>
+    Scroll,      // scroll <dy>
+    Key,         // key <name>
+    Camera,      // camera <yaw> <pitch> <distance>
+    End,         // end
+};
+
+// 单个回放事件（时间为模拟时间，单位秒）
+struct ReplayEvent {
+    double time = 0.0;
+    ReplayEventType type = ReplayEventType::End;
+    int code = 0;             // 鼠标按钮或键码（GLFW 编号）
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+};
+
+// 回放脚本：按时间排序的输入事件
+//
+// 文本格式，每行 "<时间> <事件> <参数...>"，# 之后为注释：
+//   0.00  key ENTER
+//   0.50  move 640 360
+//   0.55  down left
+//   0.60  up left
+//   1.00  scroll -1
+//   1.20  camera -90 52 15
+//   6.00  end
+class ReplayScript {
+public:
+    bool load(const std::string& path);
+
+    bool empty() const { return m_events.empty(); }
+    const std::string& error() const { return m_error; }
+
+    // 取出时间不晚于 simTime 的下一个事件；没有则返回 nullptr
+    const ReplayEvent* next(double simTime);
+
+    // 脚本是否已全部派发（或遇到 end）
+    bool finished() const;
+
+    // 脚本最后一个事件的时间
+    double duration() const;
+
+private:
+    std::vector<ReplayEvent> m_events;
+    size_t m_cursor = 0;
+    bool m_ended = false;
+    std::string m_error;
+};
+
+// 单帧耗时（毫秒）
+struct FrameTiming {
+    double simTime = 0.0;
+    double updateMs = 0.0;
+    double renderMs = 0.0;
+    double totalMs = 0.0;
+    RenderStats render;
+};
+
+// 帧耗时统计：逐帧记录并输出汇总
+class FrameStats {
+public:
+    void record(const FrameTiming& t) { m_frames.push_back(t); }
+    size_t count() const { return m_frames.size(); }
+
+    // 逐帧 CSV：frame,sim_time,update_ms,render_ms,total_ms 及各渲染计数
+    bool writeCsv(const std::string& path) const;
+
+    // 汇总：耗时平均/最小/分位数/最大，渲染计数的每帧平均
+    std::string summary() const;
+
+private:
+    std::vector<FrameTiming> m_frames;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Mesh.hpp"
+#include "Texture.hpp"
+#include "TextureStreamer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// 内容哈希（FNV-1a，按 8 字节一步，尾部逐字节）；h 可传入上一段的结果以串接多段数据
+inline constexpr uint64_t CONTENT_HASH_SEED = 1469598103934665603ull;
+uint64_t contentHash(const void* data, size_t bytes, uint64_t h = CONTENT_HASH_SEED);
+
+// 显存统计的资源类别
+enum class ResourceCategory : uint8_t {
+    UiTexture,    // 界面背景与覆盖图
+    ModelTexture, // 模型反照率、法线贴图
+    TextureArray, // 棋子反照率纹理数组
+    Mesh,         // 顶点与索引缓冲
+    RenderTarget, // 阴影贴图等
+    Count,
+};
+
+const char* resourceCategoryName(ResourceCategory c);
+
+// 纹理句柄：持有同一纹理的句柄共享一个 GL 对象，最后一个句柄释放时删除；空句柄 valid() 为 false
+class TextureRef {
+public:
+    TextureRef() = default;
+    explicit TextureRef(std::shared_ptr<const Texture2D> texture) : m_texture(std::move(texture)) {}
+
+    bool valid() const { return m_texture && m_texture->valid(); }
+    GLuint id() const { return m_texture ? m_texture->id() : 0; }
+
+private:
+    std::shared_ptr<const Texture2D> m_texture;
+};
+
+// 网格句柄（Mesh 本身不可复制，共享即共享其 VAO/VBO/EBO）
+using MeshRef = std::shared_ptr<const Mesh>;
+
+// 单个类别的统计
+struct ResourceCategoryStats {
+    uint32_t resources = 0; // 存活的资源数
+    uint32_t handles = 0;   // 句柄总数（同一资源被多处持有时大于 resources）
+    uint32_t dedupHits = 0; // 按内容命中已有资源的次数（累计）
+    size_t bytes = 0;       // 估计显存
+    size_t savedBytes = 0;  // 命中的资源若各自创建需要的额外显存（按存活资源的当前大小计）
+};
+
+// 资源管理器：纹理与网格按内容哈希去重，经句柄共享并引用计数，按类别估计显存。
+//
+// 管理器只保存弱引用，资源的生命周期由句柄决定；已释放的资源不计入统计，同一内容再次请求时重新创建。
+// 内容相同的两份数据无论来自哪个文件都得到同一个 GL 对象。所有调用须在 GL 线程。
+class ResourceManager {
+public:
+    // streamer 可为空或未启动，此时纹理同步上传
+    void init(TextureStreamer* streamer) { m_streamer = streamer; }
+    TextureStreamer* streamer() const { return m_streamer; }
+
+    // 按内容哈希取纹理，未命中时调用 create 创建；mip 只用于显存估计
+    TextureRef acquireTexture(uint64_t hash, ResourceCategory category, bool mip, const std::function<Texture2D()>& create);
+
+    // 读入图片文件并按文件内容去重，解码与上传经 streamer 异步完成；文件不存在时返回空句柄
+    TextureRef loadTexture(const std::string& path, ResourceCategory category, bool mip);
+
+    // 按内容哈希取网格，未命中时调用 create 创建
+    MeshRef acquireMesh(uint64_t hash, const std::function<Mesh()>& create);
+
+    // 不经去重的资源（纹理数组、阴影贴图）：按名字登记其显存，bytes 为 0 时移除
+    void setExternalBytes(const std::string& name, ResourceCategory category, size_t bytes);
+
+    std::array<ResourceCategoryStats, (size_t)ResourceCategory::Count> stats() const;
+    size_t totalBytes(ResourceCategory category) const;
+
+    // 把各类别的统计写入日志
+    void logStats() const;
+
+private:
+    struct TextureEntry {
+        std::weak_ptr<const Texture2D> texture;
+        ResourceCategory category = ResourceCategory::ModelTexture;
+        bool mip = false;
+        uint32_t hits = 0;
+    };
+    struct MeshEntry {
+        std::weak_ptr<const Mesh> mesh;
+        uint32_t hits = 0;
+    };
+    struct ExternalEntry {
+        ResourceCategory category = ResourceCategory::RenderTarget;
+        size_t bytes = 0;
+    };
+
+    TextureStreamer* m_streamer = nullptr;
+    std::unordered_map<uint64_t, TextureEntry> m_textures;
+    std::unordered_map<uint64_t, MeshEntry> m_meshes;
+    std::unordered_map<std::string, ExternalEntry> m_external;
+    std::array<uint32_t, (size_t)ResourceCategory::Count> m_hits{}; // 含已释放资源的累计命中
+};
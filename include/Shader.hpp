@@ -2,13 +2,72 @@
 
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 着色器变量槽：链接时解析的位置与最近一次上传的值
+struct UniformSlot {
+    GLint location = -1;
+    GLenum type = 0;
+    bool hasValue = false;
+    alignas(16) unsigned char value[64] = {};
+};
+
+// 着色器变量调用计数（跨所有着色器累计）
+struct UniformStats {
+    uint64_t uploads = 0;     // 实际发出的 glUniform* 调用
+    uint64_t skipped = 0;     // 与缓存值相同而跳过的上传
+    uint64_t nameLookups = 0; // 按名字查表的 set*() 调用
+};
+
+namespace shader_detail {
+
+void upload(GLint loc, int v);
+void upload(GLint loc, float v);
+void upload(GLint loc, const glm::vec2& v);
+void upload(GLint loc, const glm::vec3& v);
+void upload(GLint loc, const glm::vec4& v);
+void upload(GLint loc, const glm::mat4& m);
+
+// 与缓存值比较；相同返回 true（应跳过），否则写入缓存并返回 false
+bool unchanged(UniformSlot& slot, const void* data, size_t size);
+
+} // namespace shader_detail
+
+// 类型化着色器变量句柄：初始化时解析一次，之后直接按位置上传
+// 句柄指向 Shader 内部的槽，仅在所属着色器存活期间有效。
+template <typename T>
+class Uniform {
+public:
+    Uniform() = default;
+    explicit Uniform(UniformSlot* slot) : m_slot(slot) {}
+
+    bool valid() const { return m_slot && m_slot->location >= 0; }
+
+    // 调用方需保证所属程序已通过 use() 绑定
+    void set(const T& v) const {
+        static_assert(sizeof(T) <= sizeof(UniformSlot::value), "uniform value too large");
+        if (!m_slot || m_slot->location < 0) return;
+        if (shader_detail::unchanged(*m_slot, &v, sizeof(T))) return;
+        shader_detail::upload(m_slot->location, v);
+    }
+
+private:
+    UniformSlot* m_slot = nullptr;
+};
 
 // 简单的着色器封装
 class Shader {
 public:
     Shader() = default;
-    Shader(const std::string& vertexPath, const std::string& fragmentPath);
+    // defines 按顺序注入到两个阶段的 #version 行之后，每项为 "NAME" 或 "NAME VALUE"
+    Shader(const std::string& vertexPath, const std::string& fragmentPath,
+           const std::vector<std::string>& defines = {});
     ~Shader();
 
     Shader(const Shader&) = delete;
@@ -20,12 +79,56 @@ public:
     void use() const;
     GLuint id() const { return m_program; }
 
+    // 获取类型化句柄；不存在（或被编译器优化掉）的变量返回空句柄，set() 为空操作
+    template <typename T>
+    Uniform<T> uniform(const std::string& name) const {
+        return Uniform<T>(findSlot(name));
+    }
+
     void setMat4(const std::string& name, const glm::mat4& m) const;
     void setVec3(const std::string& name, const glm::vec3& v) const;
     void setVec4(const std::string& name, const glm::vec4& v) const;
     void setFloat(const std::string& name, float f) const;
     void setInt(const std::string& name, int i) const;
 
+    static const UniformStats& uniformStats();
+    static void resetUniformStats();
+
 private:
     GLuint m_program = 0;
+
+    // 链接后遍历活动变量建立的位置表；槽数组链接后不再扩容，句柄可安全持有指针
+    std::unordered_map<std::string, size_t> m_uniformIndex;
+    mutable std::vector<UniformSlot> m_slots;
+
+    void introspect();
+    void bindUniformBlocks();
+    UniformSlot* findSlot(const std::string& name) const;
+};
+
+// 着色器变体：同一对源码按特性位掩码注入 #define，每个掩码只编译一次
+// 第 i 位对应 features[i]；公共定义（如滤波核）对所有变体生效，修改后清空缓存。
+class ShaderVariants {
+public:
+    ShaderVariants() = default;
+    ShaderVariants(std::string vertexPath, std::string fragmentPath, std::vector<std::string> features);
+
+    // 获取（必要时编译）掩码对应的程序；编译失败抛出异常，并记住该掩码不再重试
+    const Shader& get(uint32_t mask);
+
+    // 该掩码是否已编译失败（调用方应直接回退，避免每帧重编译）
+    bool failed(uint32_t mask) const { return m_failed.count(mask) != 0; }
+
+    void setCommonDefines(std::vector<std::string> defines);
+
+    size_t compiledCount() const { return m_programs.size(); }
+
+private:
+    std::string m_vertexPath;
+    std::string m_fragmentPath;
+    std::vector<std::string> m_features;
+    std::vector<std::string> m_common;
+    // 程序地址需稳定（变量句柄指向其内部槽）
+    std::unordered_map<uint32_t, std::unique_ptr<Shader>> m_programs;
+    std::unordered_set<uint32_t> m_failed;
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <glad/gl.h>
+
+#include <cstddef>
+
+// 把 bytes 字节写入流式数组缓冲 vbo（每批/每帧整体重写的顶点或实例数据）。
+// 每次先整体重新分配（孤立旧存储）再写入，驱动无需等待仍在读取上一批数据的绘制；
+// capacity 为调用方保存的当前容量（字节），不足时至少翻倍。调用后 GL_ARRAY_BUFFER 解绑。
+void uploadStreamBuffer(GLuint vbo, size_t& capacity, const void* data, size_t bytes);
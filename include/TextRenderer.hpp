@@ -1,18 +1,55 @@
 #pragma once
 
+#include "GlyphRasterizer.hpp"
 #include "Shader.hpp"
+#include "Vfs.hpp"
 
 #include <glad/gl.h>
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
-// 单个字形缓存
+// 单个字形缓存（位图位于某个图集页中）
 struct Glyph {
-    GLuint texture = 0;
+    int page = -1;           // 图集页下标；空白字形为 -1
+    glm::ivec2 atlasPos{};   // 页内像素位置（位图首行所在行）
     glm::ivec2 size{};
     glm::ivec2 bearing{};
     unsigned int advance = 0;
+    int ascent = 0;  // 用于测量：基线以上高度（距离场模式下不含扩散边）
+    int descent = 0;
+};
+
+// 字形图集页：单通道纹理，货架式装箱；放不下时先倍增尺寸，到上限后另开新页
+struct GlyphAtlasPage {
+    struct Shelf {
+        int y = 0;
+        int height = 0;
+        int x = 0; // 下一个字形的起始列
+    };
+
+    GLuint texture = 0;
+    int size = 0;
+    std::vector<unsigned char> pixels; // CPU 副本，倍增时整体重新上传
+    std::vector<Shelf> shelves;
+};
+
+// 文字顶点：屏幕坐标、图集像素坐标、颜色与距离场效果（不同颜色/效果的文字可在同一批中绘制）
+struct TextVertex {
+    glm::vec2 pos;
+    glm::vec2 uv;
+    glm::vec4 color;
+    glm::vec4 effect; // xy 阴影采样偏移（图集像素），z 阴影不透明度，w 描边宽度（距离场单位）
+};
+
+// 距离场模式下的文字效果（位图模式忽略）
+struct TextEffect {
+    glm::vec2 shadowOffset{0.0f}; // 屏幕像素，(2,-2) 为右下
+    float shadowAlpha = 0.0f;
+    float outline = 0.0f;         // 描边宽度（屏幕像素）
 };
 
 // 文本测量结果
@@ -22,31 +59,107 @@ struct TextMetrics {
     float descent = 0.0f;
 };
 
+// 排版结果：以原点为基线起点、已乘缩放的字形四边形，按图集页分段
+struct TextLayout {
+    struct Run {
+        int page = 0;
+        uint32_t first = 0; // vertices 中的起始顶点
+        uint32_t count = 0;
+    };
+
+    std::string text;
+    float scale = 1.0f;
+    uint64_t hash = 0;
+    TextMetrics metrics;
+    std::vector<TextVertex> vertices; // 颜色在追加时填入
+    std::vector<Run> runs;
+
+    // LRU 链表（缓存槽位下标，-1 为空）
+    int32_t prev = -1;
+    int32_t next = -1;
+};
+
+// 排版缓存命中统计（调用方按帧清零）
+struct TextLayoutStats {
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+};
+
 // 文本渲染器（FreeType）
 class TextRenderer {
 public:
     TextRenderer() = default;
     ~TextRenderer();
 
+    // 字形生成方式，需在 init 前设置；距离场不可用时 init 回退为位图
+    void setSdf(bool enabled) { m_wantSdf = enabled; }
+    bool sdf() const { return m_sdf; }
+
     bool init(const std::string& fontPath, int viewportW, int viewportH);
     void resize(int viewportW, int viewportH);
 
-    void preload(const std::string& utf8);
-    TextMetrics measureText(const std::string& utf8, float scale);
-    void renderText(const std::string& utf8, float x, float y, float scale, const glm::vec3& color);
+    void preload(std::string_view utf8);
+    TextMetrics measureText(std::string_view utf8, float scale);
+
+    // 立即绘制一段文字（等价于 appendText + flush）
+    void renderText(std::string_view utf8, float x, float y, float scale, const glm::vec3& color);
+
+    // 把文字四边形追加到当前批次；flush 时一次上传，每个图集页一次绘制
+    void appendText(std::string_view utf8, float x, float y, float scale, const glm::vec3& color,
+                    const TextEffect& effect = TextEffect{});
+    void flush();
+    bool hasPending() const { return m_pendingQuads > 0; }
+
+    size_t atlasPageCount() const { return m_pages.size(); }
+
+    const TextLayoutStats& layoutStats() const { return m_layoutStats; }
+    void resetLayoutStats() { m_layoutStats = TextLayoutStats{}; }
 
 private:
     bool loadGlyph(char32_t cp);
+    void loadGlyphs(const std::vector<char32_t>& cps);
+    bool storeGlyph(char32_t cp, Glyph g, const unsigned char* pixels, int pitch);
+    bool allocateGlyph(int w, int h, int& page, glm::ivec2& pos);
+    bool packIntoPage(GlyphAtlasPage& page, int w, int h, glm::ivec2& pos) const;
+    void growPage(GlyphAtlasPage& page, int newSize);
+    void uploadPage(const GlyphAtlasPage& page);
+
+    // 排版缓存：按 (文字, 缩放) 查找，未命中时解码并排版，满时淘汰最久未用的槽位
+    const TextLayout& layout(std::string_view utf8, float scale);
+    void buildLayout(TextLayout& entry);
+    void touchLayout(int32_t slot);
+    void unlinkLayout(int32_t slot);
 
     Shader m_shader;
+    Uniform<glm::mat4> m_uProjection;
+    Uniform<int> m_uText;
     GLuint m_vao = 0;
     GLuint m_vbo = 0;
+    size_t m_vboCapacity = 0; // 字节
+
+    std::vector<GlyphAtlasPage> m_pages;
+    std::vector<std::vector<TextVertex>> m_pageVertices; // 当前批次，按图集页分组
+    std::vector<TextVertex> m_upload;
+    size_t m_pendingQuads = 0;
 
     int m_w = 1;
     int m_h = 1;
 
+    vfs::File m_font; // FT_Face 引用这份内存，须比 face 活得久
     void* m_ftLib = nullptr;
     void* m_ftFace = nullptr;
 
+    bool m_wantSdf = true;
+    bool m_sdf = false;
+    GlyphRasterizer m_rasterizer;
+    std::vector<char32_t> m_missing;
+    std::vector<RasterizedGlyph> m_rasterized;
+
     std::unordered_map<char32_t, Glyph> m_glyphs;
+
+    std::vector<TextLayout> m_layouts;                 // 固定槽位，复用各自的顶点缓冲
+    std::unordered_map<uint64_t, int32_t> m_layoutIndex;
+    int32_t m_lruHead = -1; // 最近使用
+    int32_t m_lruTail = -1; // 最久未用
+    TextLayoutStats m_layoutStats;
 };
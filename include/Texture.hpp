@@ -1,8 +1,12 @@
 #pragma once
 #include <glad/gl.h>
+#include <memory>
 #include <string>
 #include <vector>
 
+struct TextureStream;
+class TextureStreamer;
+
 // 2D 纹理封装
 class Texture2D {
 public:
@@ -15,9 +19,16 @@ public:
     Texture2D(Texture2D&& other) noexcept;
     Texture2D& operator=(Texture2D&& other) noexcept;
 
-    bool valid() const { return m_id != 0; }
+    bool valid() const { return m_id != 0 && resident(); }
     GLuint id() const { return m_id; }
 
+    // 像素尺寸（异步纹理在解码完成前为 0）
+    int width() const;
+    int height() const;
+
+    // 异步创建的纹理在全部像素上传完成前不驻留，此时 valid() 为 false
+    bool resident() const;
+
     // 从文件路径加载（png/jpg/...）
     static Texture2D fromFile(const std::string& path, bool generateMipmaps = true);
 
@@ -27,6 +38,52 @@ public:
     // 从原始 RGBA/RGB 像素加载
     static Texture2D fromPixels(const unsigned char* pixels, int w, int h, int channels, bool generateMipmaps = true);
 
+    // 解码压缩图片为 RGBA 像素（不涉及 GL 调用，可在工作线程中使用）
+    static bool decodeRgba(const unsigned char* data, int sizeBytes, std::vector<unsigned char>& rgba, int& w, int& h);
+
+    // 异步加载：立即返回纹理名，解码与上传由 streamer 在后续帧中完成；streamer 未启动时同步加载
+    static Texture2D fromFileAsync(TextureStreamer& streamer, const std::string& path, bool generateMipmaps = true);
+    static Texture2D fromEncodedAsync(TextureStreamer& streamer, std::vector<unsigned char> bytes, const std::string& label, bool mip);
+    static Texture2D fromPixelsAsync(TextureStreamer& streamer, std::vector<unsigned char> rgba, int w, int h, bool generateMipmaps = true);
+
+private:
+    GLuint m_id = 0;
+    int m_width = 0;
+    int m_height = 0;
+    std::shared_ptr<TextureStream> m_stream;
+};
+
+// 2D 纹理数组：同尺寸的多张 RGBA 图像按层存放，着色器以 (uv, 层号) 采样
+class Texture2DArray {
+public:
+    Texture2DArray() = default;
+    ~Texture2DArray();
+
+    Texture2DArray(const Texture2DArray&) = delete;
+    Texture2DArray& operator=(const Texture2DArray&) = delete;
+
+    Texture2DArray(Texture2DArray&& other) noexcept;
+    Texture2DArray& operator=(Texture2DArray&& other) noexcept;
+
+    bool valid() const { return m_id != 0; }
+    GLuint id() const { return m_id; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int layers() const { return m_layers; }
+
+    // 分配 layers 层 w x h 的 RGBA8 存储，内容未定义；mip 为真时在 generateMips 后按三线性过滤
+    static Texture2DArray create(int w, int h, int layers, bool mip);
+
+    // 上传一层像素（RGBA，w x h，行自下而上）
+    void uploadLayer(int layer, const unsigned char* rgba);
+
+    // 全部层上传后生成多级渐远纹理（未启用 mip 时无操作）
+    void generateMips();
+
 private:
     GLuint m_id = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_layers = 0;
+    bool m_mip = false;
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 纹理数组装箱（纯 CPU）：收集若干 RGBA 图像，选出统一的层尺寸，把能装入的图像缩放到该尺寸并分配层号
+//
+// 层尺寸取出现次数最多的图像尺寸（并列时取面积较大者）。宽高比与层尺寸相同的图像双线性缩放后装入；
+// 宽高比不同的图像不装入（缩放会拉伸，补边又要改写 UV），layer 保持 -1，由调用方单独建纹理。
+// 内容哈希相同的图像只保存第一份，其余记为它的副本并共用同一层。
+class TextureArrayPacker {
+public:
+    struct Image {
+        std::string key;
+        std::vector<unsigned char> rgba; // pack 后装入的图像已是层尺寸
+        int width = 0;
+        int height = 0;
+        int layer = -1;
+        uint64_t hash = 0;
+        int source = -1; // 副本：与之内容相同的图像下标（rgba 为空）
+    };
+
+    // hash 为 0 时不参与去重
+    void add(std::string key, std::vector<unsigned char> rgba, int w, int h, uint64_t hash = 0);
+
+    // 选层尺寸并分配层号（按加入顺序，最多 maxLayers 层）；返回装入的层数
+    int pack(int maxLayers);
+
+    int layerWidth() const { return m_layerW; }
+    int layerHeight() const { return m_layerH; }
+    int layerCount() const { return m_layerCount; }
+    int duplicateCount() const { return m_duplicates; }
+
+    bool empty() const { return m_images.empty(); }
+    std::vector<Image>& images() { return m_images; }
+    void clear();
+
+private:
+    std::vector<Image> m_images;
+    std::unordered_map<uint64_t, int> m_byHash;
+    int m_duplicates = 0;
+    int m_layerW = 0;
+    int m_layerH = 0;
+    int m_layerCount = 0;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <glad/gl.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 一张异步上传中的纹理：GL 线程与工作线程共享，Texture2D 持有一份用于查询是否已驻留
+struct TextureStream {
+    GLuint texture = 0;
+    bool mip = false;
+    std::string path; // 为空时像素由调用方提供
+    std::vector<unsigned char> encoded; // 调用方已读入的压缩图片字节：非空时从此解码，path 只用于日志
+
+    // 解码结果（工作线程写入，decoded 置位后 GL 线程只读）
+    std::vector<unsigned char> pixels; // RGBA，行自下而上
+    int width = 0;
+    int height = 0;
+    std::atomic<int> decoded{0}; // 0 进行中，1 成功，-1 失败
+
+    // 以下只在 GL 线程访问
+    int nextRow = 0;     // 下一个分配到 PBO 的行
+    int uploadedRows = 0;
+    bool allocated = false;
+    bool resident = false;
+    bool cancelled = false; // Texture2D 已销毁
+};
+
+// 每帧上传统计
+struct TextureStreamStats {
+    uint32_t uploadBytes = 0; // 本帧 glTexSubImage2D 提交的字节数
+    uint32_t uploads = 0;     // 本帧提交的行带数
+    uint32_t pending = 0;     // 尚未驻留的纹理数
+};
+
+// 纹理流式上传：工作线程解码并把行带写入已映射的 PBO 环，GL 线程在字节预算内从 PBO 提交
+// glTexSubImage2D，并用栅栏回收 PBO。所有 GL 调用都在 init()/update()/enqueue*()/shutdown() 中，须在 GL 线程调用。
+class TextureStreamer {
+public:
+    TextureStreamer() = default;
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // slotBytes：单个 PBO 容量（即一次行带上传的上限）；slotCount：环中 PBO 数
+    bool init(size_t slotBytes, int slotCount, unsigned threadCount);
+    bool running() const { return !m_threads.empty(); }
+
+    // 停止并等待工作线程，再解除映射并删除全部 PBO 与栅栏；须在 GL 上下文销毁前调用。
+    // 析构只停止线程（此时上下文可能已不存在）。
+    void shutdown();
+
+    std::shared_ptr<TextureStream> enqueueFile(GLuint texture, const std::string& path, bool mip);
+    std::shared_ptr<TextureStream> enqueueEncoded(GLuint texture, std::vector<unsigned char> bytes, const std::string& label, bool mip);
+    std::shared_ptr<TextureStream> enqueuePixels(GLuint texture, std::vector<unsigned char> rgba, int w, int h, bool mip);
+
+    // 每帧调用：回收栅栏已完成的 PBO，在预算内提交已填好的行带，再把空闲 PBO 映射后交给工作线程填充
+    void update(size_t budgetBytes);
+
+    const TextureStreamStats& stats() const { return m_stats; }
+
+    // 尚未驻留（含解码中）的纹理数
+    size_t pending() const { return m_streams.size(); }
+
+private:
+    enum class SlotState : uint8_t {
+        Free,
+        Filling,  // 已映射，工作线程写入中
+        InFlight, // 已提交 glTexSubImage2D，等待栅栏
+    };
+
+    struct Slot {
+        GLuint pbo = 0;
+        SlotState state = SlotState::Free;
+        GLsync fence = nullptr;
+        void* mapped = nullptr;
+        std::shared_ptr<TextureStream> stream;
+        int row0 = 0;
+        int rows = 0;
+        std::atomic<bool> filled{false};
+    };
+
+    struct Job {
+        std::shared_ptr<TextureStream> stream; // 解码任务
+        Slot* slot = nullptr;                  // 填充任务
+    };
+
+    void post(Job job);
+    void stopWorkers();
+    void workerMain();
+    void submitSlot(Slot& slot);
+    void allocate(TextureStream& s);
+    void finish(TextureStream& s);
+
+    size_t m_slotBytes = 0;
+    std::unique_ptr<Slot[]> m_slots;
+    int m_slotCount = 0;
+    std::deque<std::shared_ptr<TextureStream>> m_streams; // 提交顺序，驻留或失败后移除
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Job> m_jobs;
+    bool m_stop = false;
+
+    TextureStreamStats m_stats;
+};
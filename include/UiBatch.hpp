@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Shader.hpp"
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// UI 矩形区域
+struct UiRect {
+    float x = 0.0f;
+    float y = 0.0f;
+    float w = 0.0f;
+    float h = 0.0f;
+};
+
+// 界面顶点：屏幕坐标 + 纹理坐标、颜色、纹理混合权重
+struct UiVertex {
+    glm::vec4 posUV;  // xy 像素坐标，zw 纹理坐标
+    glm::vec4 color;
+    glm::vec2 mode;   // x 纹理颜色权重，y 纹理透明度权重
+};
+
+// 界面批次统计（调用方按帧清零）
+struct UiBatchStats {
+    uint32_t quads = 0;
+    uint32_t batches = 0;
+};
+
+// 2D 即时批处理：矩形追加到 CPU 顶点表，纹理变化或 flush 时一次上传并绘制
+//
+// 纯色矩形不依赖纹理（颜色权重为 0），可与任意纹理矩形合批；只有两个不同的纹理相遇才会切批。
+// 投影取自 FrameData 统一缓冲块，调用方负责绑定界面帧常量。
+class UiBatcher {
+public:
+    UiBatcher() = default;
+    ~UiBatcher();
+
+    UiBatcher(const UiBatcher&) = delete;
+    UiBatcher& operator=(const UiBatcher&) = delete;
+
+    bool init();
+
+    // tex 为 0 时为纯色矩形；texAlpha 为真时乘上纹理透明度
+    void addRect(const UiRect& r, const glm::vec4& color, GLuint tex = 0, bool texAlpha = false);
+    void flush();
+    bool hasPending() const { return !m_vertices.empty(); }
+
+    const UiBatchStats& stats() const { return m_stats; }
+    void resetStats() { m_stats = UiBatchStats{}; }
+
+private:
+    Shader m_shader;
+    GLuint m_vao = 0;
+    GLuint m_vbo = 0;
+    size_t m_vboCapacity = 0; // 字节
+
+    std::vector<UiVertex> m_vertices;
+    GLuint m_texture = 0; // 当前批次的纹理（0 为尚未出现纹理矩形）
+    UiBatchStats m_stats;
+};
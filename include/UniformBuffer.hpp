@@ -0,0 +1,74 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <string>
+
+// 统一缓冲块的固定绑定点（着色器链接时按块名绑定）
+inline constexpr GLuint UBO_BINDING_FRAME = 0;    // FrameData
+inline constexpr GLuint UBO_BINDING_MATERIAL = 1; // MaterialData
+
+// 块名对应的绑定点；未知块返回 -1
+int uniformBlockBinding(const std::string& blockName);
+
+// FrameData（std140）：相机/光照/时间，每帧上传一次
+// 与着色器中的声明逐字段对应：
+//   layout (std140) uniform FrameData {
+//       mat4 view; mat4 projection; mat4 lightSpaceMatrix;
+//       vec3 lightDir; float time; vec3 viewPos;
+//   };
+struct FrameUniforms {
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::mat4 lightSpaceMatrix = glm::mat4(1.0f);
+    glm::vec3 lightDir = glm::vec3(0.0f, 0.0f, -1.0f);
+    float time = 0.0f;
+    glm::vec3 viewPos = glm::vec3(0.0f, 0.0f, 1.0f);
+    float pad0 = 0.0f;
+};
+static_assert(sizeof(FrameUniforms) == 224, "FrameUniforms must match std140 FrameData");
+
+// MaterialData（std140）：材质参数
+struct MaterialUniforms {
+    float roughness = 1.0f;
+    float metalness = 0.0f;
+    float pad0 = 0.0f;
+    float pad1 = 0.0f;
+};
+static_assert(sizeof(MaterialUniforms) == 16, "MaterialUniforms must match std140 MaterialData");
+
+// 统一缓冲对象封装
+class UniformBuffer {
+public:
+    UniformBuffer() = default;
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    UniformBuffer(UniformBuffer&& other) noexcept;
+    UniformBuffer& operator=(UniformBuffer&& other) noexcept;
+
+    bool valid() const { return m_id != 0; }
+    GLuint id() const { return m_id; }
+    size_t size() const { return m_size; }
+
+    // 创建指定大小的缓冲；data 为空时内容未定义
+    static UniformBuffer create(size_t size, const void* data = nullptr, GLenum usage = GL_DYNAMIC_DRAW);
+
+    // 整体替换内容：先孤立旧存储，驱动无需等待仍在读取旧数据的绘制
+    void update(const void* data, size_t size);
+
+    // 将 [offset, offset+size) 绑定到绑定点；offset 需按 offsetAlignment() 对齐
+    void bindRange(GLuint binding, size_t offset, size_t size) const;
+
+    // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT，以及按它向上取整
+    static size_t offsetAlignment();
+    static size_t alignOffset(size_t n);
+
+private:
+    GLuint m_id = 0;
+    size_t m_size = 0;
+    GLenum m_usage = GL_DYNAMIC_DRAW;
+};
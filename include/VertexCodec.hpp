@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <cstddef>
+
+// VertexPN <-> VertexPacked 编解码（导入期在 CPU 上完成，解码与 GL 的定点展开规则一致）
+namespace vertexcodec {
+
+// 打包后允许的最大误差，超出任一项时该网格保留完整格式
+inline constexpr float MAX_POS_ERROR = 1e-4f;        // 相对网格最大跨度
+inline constexpr float MAX_NORMAL_ERROR_DEG = 0.5f;  // 法线夹角（度）
+inline constexpr float MAX_UV_ERROR = 1.0f / 4096.0f; // 绝对值；平铺 UV（|uv| >= 1）通常超出
+
+// 往返误差：逐顶点解码后与原值比较得到的最大值
+struct PackError {
+    float pos = 0.0f; // 相对最大跨度
+    float normalDeg = 0.0f;
+    float uv = 0.0f;
+
+    bool withinBounds() const {
+        return pos <= MAX_POS_ERROR && normalDeg <= MAX_NORMAL_ERROR_DEG && uv <= MAX_UV_ERROR;
+    }
+};
+
+// 按顶点包围盒量化打包 count 个顶点，并解码回来测得 err
+void pack(const VertexPN* in, size_t count, VertexPacked* out, VertexDequant& dequant, PackError& err);
+
+// 按着色器中的规则还原一个顶点（法线未再归一化）
+VertexPN unpack(const VertexPacked& v, const VertexDequant& dequant);
+
+} // namespace vertexcodec
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 只读虚拟文件系统：assets/ 下的资源从挂载的资源包（一次 mmap）中读取。
+//
+// 资源包中找不到的 assets/ 路径，仅在开发构建（定义 XIANGQI3D_LOOSE_ASSETS）时回退到磁盘上的散文件；
+// assets/ 以外的路径（模型缓存、用户回放等）总是直接读磁盘。
+// mount/unmount 须在其他线程开始读取前/结束读取后调用；挂载期间的查询只读，可在任意线程进行。
+namespace vfs {
+
+// 文件内容：未压缩的包内条目直接指向映射区（unmount 前有效），其余情况持有自己的缓冲
+class File {
+public:
+    File() = default;
+
+    bool valid() const { return m_data != nullptr; }
+    const unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    std::string_view text() const { return std::string_view(reinterpret_cast<const char*>(m_data), m_size); }
+
+private:
+    friend File open(const std::string& path);
+
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+    std::shared_ptr<const std::vector<unsigned char>> m_owned;
+};
+
+// 文件身份（大小 + 修改时间），用于缓存失效判断
+struct Stat {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+// 挂载资源包；失败时保持未挂载
+bool mount(const std::string& packPath);
+void unmount();
+bool mounted();
+
+// 统一路径写法：'\\' 换成 '/'，去掉 "." 段并折叠 ".." 段
+std::string normalize(std::string_view path);
+
+bool exists(const std::string& path);
+bool stat(const std::string& path, Stat& out);
+
+// 打开并读入整个文件；不存在、空文件或解压失败时返回无效的 File
+File open(const std::string& path);
+
+// 读入文本文件，失败时抛出 std::runtime_error（与 util::readTextFile 一致）
+std::string readText(const std::string& path);
+
+} // namespace vfs
@@ -4,6 +4,7 @@
 #include "Types.hpp"
 #include "XiangqiRules.hpp"
 
+#include <array>
 #include <optional>
 #include <string>
 #include <vector>
@@ -42,7 +43,7 @@ public:
     const BoardState& board() const { return m_board; }
 
     std::optional<Pos> selected() const { return m_selected; }
-    const std::vector<Pos>& legalTargets() const { return m_legalTargets; }
+    const std::vector<Pos>& legalTargets() const;
 
     const std::vector<CaptureVisual>& captures() const { return m_captures; }
     const std::vector<MoveVisual>& moves() const { return m_moves; }
@@ -80,7 +81,10 @@ private:
     GameStatus m_status = GameStatus::Ongoing;
 
     std::optional<Pos> m_selected;
-    std::vector<Pos> m_legalTargets;
+
+    // 当前局面走子方的全部合法走法，按起点格分组；每步棋后重建一次
+    std::array<std::array<std::vector<Pos>, 9>, 10> m_legalByFrom{};
+    size_t m_legalMoveCount = 0;
 
     std::vector<CaptureVisual> m_captures;
     std::vector<MoveVisual> m_moves;
@@ -94,6 +98,6 @@ private:
     std::string m_eventText;
     float m_eventTimer = 0.0f; // 剩余秒数；<0 表示永久
 
-    void computeLegalTargets();
+    void rebuildLegalCache();
     void afterMove();
 };
@@ -0,0 +1,112 @@
+#include "AssetLoader.hpp"
+
+#include <chrono>
+
+AssetLoader::~AssetLoader() {
+    stop();
+}
+
+bool AssetLoader::start(unsigned threadCount) {
+    stop();
+    if (threadCount == 0) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = false;
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&AssetLoader::workerMain, this);
+    }
+    return true;
+}
+
+void AssetLoader::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads) t.join();
+    m_threads.clear();
+
+    // 未开始的任务与未取走的结果一并丢弃
+    m_jobs.clear();
+    freeDone();
+    m_outstanding = 0;
+}
+
+void AssetLoader::submit(const std::string& key, const std::string& path) {
+    auto job = std::make_unique<LoadedModel>();
+    job->key = key;
+    job->path = path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_outstanding++;
+    m_wake.notify_one();
+}
+
+std::unique_ptr<LoadedModel> AssetLoader::poll() {
+    if (!m_ready) {
+        // 摘下整条链（压栈顺序为后完成在前），翻转后按完成顺序交付
+        LoadedModel* head = m_doneHead.exchange(nullptr, std::memory_order_acquire);
+        while (head) {
+            LoadedModel* next = head->next;
+            head->next = m_ready;
+            m_ready = head;
+            head = next;
+        }
+    }
+    if (!m_ready) return nullptr;
+
+    LoadedModel* item = m_ready;
+    m_ready = item->next;
+    item->next = nullptr;
+    m_outstanding--;
+    return std::unique_ptr<LoadedModel>(item);
+}
+
+void AssetLoader::pushDone(LoadedModel* item) {
+    LoadedModel* head = m_doneHead.load(std::memory_order_relaxed);
+    do {
+        item->next = head;
+    } while (!m_doneHead.compare_exchange_weak(head, item, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void AssetLoader::freeDone() {
+    LoadedModel* head = m_doneHead.exchange(nullptr, std::memory_order_acquire);
+    for (LoadedModel* list : {head, m_ready}) {
+        while (list) {
+            LoadedModel* next = list->next;
+            delete list;
+            list = next;
+        }
+    }
+    m_ready = nullptr;
+}
+
+void AssetLoader::workerMain() {
+    using Clock = std::chrono::steady_clock;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [&] { return m_stop || !m_jobs.empty(); });
+        if (m_stop) break;
+
+        std::unique_ptr<LoadedModel> job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        lock.unlock();
+
+        auto t0 = Clock::now();
+        job->ok = Model::loadData(job->path, job->data);
+        if (job->ok) {
+            Model::decodeAlbedo(job->data);
+            Model::hashContent(job->data);
+        }
+        job->workMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        pushDone(job.release());
+
+        lock.lock();
+    }
+}
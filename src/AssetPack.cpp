@@ -0,0 +1,146 @@
+#include "AssetPack.hpp"
+
+#include "Lz4.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace assetpack {
+
+namespace {
+
+size_t alignUp(size_t v) {
+    return (v + PACK_ALIGN - 1) & ~(PACK_ALIGN - 1);
+}
+
+bool inRange(uint64_t offset, uint64_t bytes, size_t fileSize) {
+    return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+bool fail(std::string* error, std::string msg) {
+    if (error) *error = std::move(msg);
+    return false;
+}
+
+} // namespace
+
+bool writePack(const std::string& path, std::vector<PackInput> inputs, bool compress, std::string* error) {
+    std::sort(inputs.begin(), inputs.end(), [](const PackInput& a, const PackInput& b) { return a.name < b.name; });
+    for (size_t i = 1; i < inputs.size(); ++i) {
+        if (inputs[i].name == inputs[i - 1].name) return fail(error, "Duplicate pack entry: " + inputs[i].name);
+    }
+
+    PackHeader header;
+    header.count = (uint32_t)inputs.size();
+    std::vector<PackEntry> entries(inputs.size());
+    std::string names;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        entries[i].nameOffset = (uint32_t)names.size();
+        entries[i].nameLength = (uint32_t)inputs[i].name.size();
+        names += inputs[i].name;
+    }
+    header.namesBytes = (uint32_t)names.size();
+
+    // 压缩不划算的条目原样存放
+    std::vector<std::vector<unsigned char>> stored(inputs.size());
+    size_t offset = alignUp(sizeof(PackHeader) + entries.size() * sizeof(PackEntry) + names.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        PackEntry& e = entries[i];
+        const std::vector<unsigned char>& raw = inputs[i].data;
+        e.size = raw.size();
+        e.mtime = inputs[i].mtime;
+        if (compress && raw.size() >= 64) {
+            std::vector<unsigned char> packed(lz4::compressBound(raw.size()));
+            size_t n = lz4::compress(raw.data(), raw.size(), packed.data(), packed.size());
+            if (n > 0 && n <= raw.size() - raw.size() / 10) {
+                packed.resize(n);
+                stored[i] = std::move(packed);
+                e.flags |= ENTRY_LZ4;
+            }
+        }
+        if (!(e.flags & ENTRY_LZ4)) stored[i] = raw;
+        e.offset = offset;
+        e.storedSize = stored[i].size();
+        offset = alignUp(offset + stored[i].size());
+    }
+
+    std::vector<unsigned char> buf(offset, 0);
+    std::memcpy(buf.data(), &header, sizeof(header));
+    if (!entries.empty()) std::memcpy(buf.data() + sizeof(header), entries.data(), entries.size() * sizeof(PackEntry));
+    if (!names.empty()) std::memcpy(buf.data() + sizeof(header) + entries.size() * sizeof(PackEntry), names.data(), names.size());
+    for (size_t i = 0; i < stored.size(); ++i) {
+        if (!stored[i].empty()) std::memcpy(buf.data() + entries[i].offset, stored[i].data(), stored[i].size());
+    }
+
+    const std::string tmp = path + ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f || !f.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size())) {
+            return fail(error, "Failed to write asset pack: " + tmp);
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return fail(error, "Failed to write asset pack: " + path + " (" + ec.message() + ")");
+    }
+    return true;
+}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(PackHeader)) return false;
+
+    PackHeader h;
+    std::memcpy(&h, file.data(), sizeof(h));
+    if (h.magic != PACK_MAGIC || h.version != PACK_VERSION) return false;
+
+    const uint64_t tableBytes = (uint64_t)h.count * sizeof(PackEntry);
+    if (!inRange(sizeof(PackHeader), tableBytes, file.size())) return false;
+    if (!inRange(sizeof(PackHeader) + tableBytes, h.namesBytes, file.size())) return false;
+
+    // 映射区按页对齐，条目表紧跟 16 字节的头，可直接按结构体访问
+    const auto* entries = reinterpret_cast<const PackEntry*>(file.data() + sizeof(PackHeader));
+    const char* names = reinterpret_cast<const char*>(file.data() + sizeof(PackHeader) + tableBytes);
+    std::string_view prev;
+    for (uint32_t i = 0; i < h.count; ++i) {
+        const PackEntry& e = entries[i];
+        if ((uint64_t)e.nameOffset + e.nameLength > h.namesBytes) return false;
+        if (!inRange(e.offset, e.storedSize, file.size())) return false;
+        if (!(e.flags & ENTRY_LZ4) && e.storedSize != e.size) return false;
+        std::string_view n(names + e.nameOffset, e.nameLength);
+        if (i > 0 && !(prev < n)) return false;
+        prev = n;
+    }
+
+    m_file = std::move(file);
+    m_entries = entries;
+    m_names = names;
+    m_count = h.count;
+    return true;
+}
+
+void AssetPack::close() {
+    m_file.close();
+    m_entries = nullptr;
+    m_names = nullptr;
+    m_count = 0;
+}
+
+const PackEntry* AssetPack::find(std::string_view key) const {
+    const PackEntry* first = m_entries;
+    const PackEntry* last = m_entries + m_count;
+    const PackEntry* it = std::lower_bound(first, last, key, [this](const PackEntry& e, std::string_view k) {
+        return name(e) < k;
+    });
+    if (it == last || name(*it) != key) return nullptr;
+    return it;
+}
+
+} // namespace assetpack
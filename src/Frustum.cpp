@@ -0,0 +1,74 @@
+#include "Frustum.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+BoxBounds transformBounds(const AABB& box, const glm::mat4& M) {
+    const glm::vec3 c = 0.5f * (box.min + box.max);
+    const glm::vec3 e = 0.5f * (box.max - box.min);
+    BoxBounds out;
+    out.center = glm::vec3(M * glm::vec4(c, 1.0f));
+    for (int i = 0; i < 3; ++i) {
+        out.extent[i] = std::fabs(M[0][i]) * e.x + std::fabs(M[1][i]) * e.y + std::fabs(M[2][i]) * e.z;
+    }
+    return out;
+}
+
+// Gribb-Hartmann：裁剪矩阵第 4 行加/减前 3 行即为左右、下上、近远平面（OpenGL 的 -w..w 深度范围）
+Frustum::Frustum(const glm::mat4& clip) {
+    auto row = [&](int r) { return glm::vec4(clip[0][r], clip[1][r], clip[2][r], clip[3][r]); };
+    const glm::vec4 planes[6] = {
+        row(3) + row(0), row(3) - row(0),
+        row(3) + row(1), row(3) - row(1),
+        row(3) + row(2), row(3) - row(2),
+    };
+    for (int i = 0; i < 6; ++i) {
+        float len = glm::length(glm::vec3(planes[i]));
+        if (len <= 0.0f) len = 1.0f;
+        m_nx[i] = planes[i].x / len;
+        m_ny[i] = planes[i].y / len;
+        m_nz[i] = planes[i].z / len;
+        m_d[i] = planes[i].w / len;
+    }
+}
+
+// 盒子在某平面外侧：中心到平面的有向距离 + 盒子沿法线的投影半径 < 0
+bool Frustum::intersects(const BoxBounds& b) const {
+#ifdef FRUSTUM_USE_SSE
+    const __m128 cx = _mm_set1_ps(b.center.x);
+    const __m128 cy = _mm_set1_ps(b.center.y);
+    const __m128 cz = _mm_set1_ps(b.center.z);
+    const __m128 ex = _mm_set1_ps(b.extent.x);
+    const __m128 ey = _mm_set1_ps(b.extent.y);
+    const __m128 ez = _mm_set1_ps(b.extent.z);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (int i = 0; i < 8; i += 4) {
+        const __m128 nx = _mm_load_ps(m_nx + i);
+        const __m128 ny = _mm_load_ps(m_ny + i);
+        const __m128 nz = _mm_load_ps(m_nz + i);
+        const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                                       _mm_add_ps(_mm_mul_ps(nz, cz), _mm_load_ps(m_d + i)));
+        const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign, nx), ex),
+                                                    _mm_mul_ps(_mm_andnot_ps(sign, ny), ey)),
+                                         _mm_mul_ps(_mm_andnot_ps(sign, nz), ez));
+        if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps())) != 0) return false;
+    }
+    return true;
+#else
+    return intersectsScalar(b);
+#endif
+}
+
+// 加法结合顺序与 SSE 路径相同，两条路径的舍入因此一致
+bool Frustum::intersectsScalar(const BoxBounds& b) const {
+    for (int i = 0; i < 6; ++i) {
+        const float dist = (m_nx[i] * b.center.x + m_ny[i] * b.center.y) + (m_nz[i] * b.center.z + m_d[i]);
+        const float radius = (std::fabs(m_nx[i]) * b.extent.x + std::fabs(m_ny[i]) * b.extent.y) + std::fabs(m_nz[i]) * b.extent.z;
+        if (dist + radius < 0.0f) return false;
+    }
+    return true;
+}
@@ -0,0 +1,142 @@
+#include "GlyphRasterizer.hpp"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+#include <cstring>
+
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+#define XQ_HAVE_FT_SDF 1
+#else
+#define XQ_HAVE_FT_SDF 0
+#endif
+
+bool GlyphRasterizer::supported() {
+    return XQ_HAVE_FT_SDF != 0;
+}
+
+GlyphRasterizer::~GlyphRasterizer() {
+    stop();
+}
+
+bool GlyphRasterizer::start(vfs::File font, int pixelSize, int spread, unsigned threadCount) {
+    stop();
+    if (!supported() || threadCount == 0 || !font.valid()) return false;
+    m_font = std::move(font);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = false;
+        m_started = 0;
+        m_failed = 0;
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&GlyphRasterizer::workerMain, this, pixelSize, spread);
+    }
+
+    bool ok;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&] { return m_started + m_failed == threadCount; });
+        ok = (m_failed == 0);
+    }
+    if (!ok) stop();
+    return ok;
+}
+
+void GlyphRasterizer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads) t.join();
+    m_threads.clear();
+    m_font = vfs::File();
+}
+
+void GlyphRasterizer::rasterize(const std::vector<char32_t>& cps, std::vector<RasterizedGlyph>& out) {
+    out.resize(cps.size());
+    if (cps.empty() || m_threads.empty()) return;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobs = &cps;
+    m_out = &out;
+    m_jobCount = cps.size();
+    m_next = 0;
+    m_remaining = cps.size();
+    m_wake.notify_all();
+    m_done.wait(lock, [&] { return m_remaining == 0; });
+    m_jobs = nullptr;
+    m_out = nullptr;
+    m_jobCount = 0;
+}
+
+// 在当前线程生成一个距离场字形；结果只写入 out，不触碰共享状态
+static void rasterizeOne(FT_Face face, char32_t cp, RasterizedGlyph& out) {
+    out = RasterizedGlyph{};
+#if XQ_HAVE_FT_SDF
+    if (FT_Load_Char(face, (FT_ULong)cp, FT_LOAD_DEFAULT | FT_LOAD_NO_BITMAP)) return;
+
+    FT_GlyphSlot slot = face->glyph;
+    out.advance = (unsigned int)slot->advance.x;
+    out.ascent = (int)(slot->metrics.horiBearingY >> 6);
+    out.descent = (int)((slot->metrics.height - slot->metrics.horiBearingY) >> 6);
+
+    // 空白字形没有轮廓，只需要步进
+    if (slot->format != FT_GLYPH_FORMAT_OUTLINE || slot->outline.n_contours <= 0) {
+        out.ok = true;
+        return;
+    }
+    if (FT_Render_Glyph(slot, FT_RENDER_MODE_SDF)) return;
+
+    const FT_Bitmap& bmp = slot->bitmap;
+    out.size = glm::ivec2((int)bmp.width, (int)bmp.rows);
+    out.bearing = glm::ivec2(slot->bitmap_left, slot->bitmap_top);
+    out.pixels.resize((size_t)out.size.x * (size_t)out.size.y);
+    for (int row = 0; row < out.size.y; ++row) {
+        std::memcpy(out.pixels.data() + (size_t)row * (size_t)out.size.x,
+                    bmp.buffer + (ptrdiff_t)row * bmp.pitch, (size_t)out.size.x);
+    }
+    out.ok = true;
+#else
+    (void)face;
+    (void)cp;
+#endif
+}
+
+void GlyphRasterizer::workerMain(int pixelSize, int spread) {
+    FT_Library lib = nullptr;
+    FT_Face face = nullptr;
+    bool ok = (FT_Init_FreeType(&lib) == 0);
+    if (ok) {
+        FT_Int value = spread;
+        FT_Property_Set(lib, "sdf", "spread", &value);
+        ok = (FT_New_Memory_Face(lib, m_font.data(), (FT_Long)m_font.size(), 0, &face) == 0);
+    }
+    if (ok) FT_Set_Pixel_Sizes(face, 0, (FT_UInt)pixelSize);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (ok) m_started++;
+    else m_failed++;
+    m_done.notify_all();
+
+    while (ok) {
+        m_wake.wait(lock, [&] { return m_stop || m_next < m_jobCount; });
+        if (m_stop) break;
+
+        size_t i = m_next++;
+        char32_t cp = (*m_jobs)[i];
+        RasterizedGlyph& out = (*m_out)[i];
+        lock.unlock();
+        rasterizeOne(face, cp, out);
+        lock.lock();
+
+        if (--m_remaining == 0) m_done.notify_all();
+    }
+    lock.unlock();
+
+    if (face) FT_Done_Face(face);
+    if (lib) FT_Done_FreeType(lib);
+}
@@ -0,0 +1,130 @@
+#include "Lz4.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace lz4 {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5; // 块末尾至少这么多字节是字面量
+constexpr size_t MF_LIMIT = 12;     // 最后一个匹配须在块末尾这么多字节之前开始
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 16;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// 写出 255 进制的长度扩展
+bool writeLength(uint8_t*& op, const uint8_t* end, size_t len) {
+    for (; len >= 255; len -= 255) {
+        if (op >= end) return false;
+        *op++ = 255;
+    }
+    if (op >= end) return false;
+    *op++ = (uint8_t)len;
+    return true;
+}
+
+// 写出一个序列：字面量 [lit, lit+litLen)，随后是 (offset, matchLen) 的匹配（matchLen 为 0 表示块尾）
+bool writeSequence(uint8_t*& op, const uint8_t* end, const uint8_t* lit, size_t litLen, size_t offset, size_t matchLen) {
+    if (op >= end) return false;
+    uint8_t* token = op++;
+    *token = (uint8_t)((litLen >= 15 ? 15 : litLen) << 4);
+    if (litLen >= 15 && !writeLength(op, end, litLen - 15)) return false;
+    if ((size_t)(end - op) < litLen) return false;
+    if (litLen) std::memcpy(op, lit, litLen);
+    op += litLen;
+    if (matchLen == 0) return true;
+
+    if (end - op < 2) return false;
+    *op++ = (uint8_t)(offset & 0xFF);
+    *op++ = (uint8_t)(offset >> 8);
+    const size_t m = matchLen - MIN_MATCH;
+    *token |= (uint8_t)(m >= 15 ? 15 : m);
+    return m < 15 || writeLength(op, end, m - 15);
+}
+
+} // namespace
+
+size_t compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+    uint8_t* op = dst;
+    const uint8_t* end = dst + capacity;
+    size_t anchor = 0;
+
+    if (size > MF_LIMIT) {
+        std::vector<uint32_t> table((size_t)1 << HASH_BITS, 0); // 位置 + 1，0 为空
+        const size_t matchLimit = size - LAST_LITERALS;
+        const size_t ipLimit = size - MF_LIMIT;
+        size_t ip = 0;
+        while (ip < ipLimit) {
+            const uint32_t seq = read32(src + ip);
+            uint32_t& slot = table[hash4(seq)];
+            const size_t cand = slot;
+            slot = (uint32_t)(ip + 1);
+            if (cand == 0 || ip - (cand - 1) > MAX_OFFSET || read32(src + cand - 1) != seq) {
+                ++ip;
+                continue;
+            }
+            const size_t ref = cand - 1;
+            size_t len = MIN_MATCH;
+            while (ip + len < matchLimit && src[ref + len] == src[ip + len]) ++len;
+            if (!writeSequence(op, end, src + anchor, ip - anchor, ip - ref, len)) return 0;
+            ip += len;
+            anchor = ip;
+        }
+    }
+    if (!writeSequence(op, end, src + anchor, size - anchor, 0, 0)) return 0;
+    return (size_t)(op - dst);
+}
+
+bool decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize) {
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + size;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + rawSize;
+
+    auto readLength = [&](size_t& len) {
+        uint8_t b;
+        do {
+            if (ip >= iend) return false;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+        size_t litLen = token >> 4;
+        if (litLen == 15 && !readLength(litLen)) return false;
+        if ((size_t)(iend - ip) < litLen || (size_t)(oend - op) < litLen) return false;
+        if (litLen) std::memcpy(op, ip, litLen);
+        ip += litLen;
+        op += litLen;
+        if (ip == iend) break; // 最后一个序列只有字面量
+
+        if (iend - ip < 2) return false;
+        const size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) return false;
+        size_t matchLen = token & 15;
+        if (matchLen == 15 && !readLength(matchLen)) return false;
+        matchLen += MIN_MATCH;
+        if ((size_t)(oend - op) < matchLen) return false;
+        const uint8_t* ref = op - offset;
+        for (size_t i = 0; i < matchLen; ++i) op[i] = ref[i]; // 可能与输出重叠，逐字节复制
+        op += matchLen;
+    }
+    return op == oend;
+}
+
+} // namespace lz4
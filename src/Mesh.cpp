@@ -1,5 +1,9 @@
 #include "Mesh.hpp"
 
+#include "RenderStats.hpp"
+
+#include <algorithm>
+
 // 释放显卡缓冲资源
 Mesh::~Mesh() {
     if (m_ebo) glDeleteBuffers(1, &m_ebo);
@@ -16,6 +20,11 @@ Mesh::Mesh(Mesh&& other) noexcept {
     m_ebo = other.m_ebo;
     m_elemCount = other.m_elemCount;
     m_indexed = other.m_indexed;
+    m_vertexCount = other.m_vertexCount;
+    m_vertexBytes = other.m_vertexBytes;
+    m_dequant = other.m_dequant;
+    std::copy(other.m_lods, other.m_lods + MAX_MESH_LODS, m_lods);
+    m_lodCount = other.m_lodCount;
     other.m_vao = other.m_vbo = other.m_ebo = 0;
     other.m_elemCount = 0;
 }
@@ -29,6 +38,11 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
         m_ebo = other.m_ebo;
         m_elemCount = other.m_elemCount;
         m_indexed = other.m_indexed;
+        m_vertexCount = other.m_vertexCount;
+        m_vertexBytes = other.m_vertexBytes;
+        m_dequant = other.m_dequant;
+        std::copy(other.m_lods, other.m_lods + MAX_MESH_LODS, m_lods);
+        m_lodCount = other.m_lodCount;
         other.m_vao = other.m_vbo = other.m_ebo = 0;
         other.m_elemCount = 0;
     }
@@ -37,9 +51,17 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
 
 // 从索引三角形创建网格（带索引缓冲）
 Mesh Mesh::fromTriangles(const std::vector<VertexPN>& verts, const std::vector<unsigned int>& indices) {
+    return fromRaw(verts.data(), verts.size(), indices.data(), indices.size());
+}
+
+// 从连续内存创建索引网格（如映射的缓存文件），数据直接交给 glBufferData
+Mesh Mesh::fromRaw(const VertexPN* verts, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
     Mesh m;
     m.m_indexed = true;
-    m.m_elemCount = static_cast<GLsizei>(indices.size());
+    m.m_elemCount = static_cast<GLsizei>(indexCount);
+    m.m_lods[0] = MeshLod{0, (uint32_t)indexCount, 0.0f};
+    m.m_vertexCount = vertexCount;
+    m.m_vertexBytes = vertexCount * sizeof(VertexPN);
 
     glGenVertexArrays(1, &m.m_vao);
     glGenBuffers(1, &m.m_vbo);
@@ -48,10 +70,10 @@ Mesh Mesh::fromTriangles(const std::vector<VertexPN>& verts, const std::vector<u
     glBindVertexArray(m.m_vao);
 
     glBindBuffer(GL_ARRAY_BUFFER, m.m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(verts.size() * sizeof(VertexPN)), verts.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m.m_vertexBytes, verts, GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m.m_ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(unsigned int)), indices.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indexCount * sizeof(unsigned int)), indices, GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexPN), (void*)offsetof(VertexPN, pos));
@@ -65,11 +87,48 @@ Mesh Mesh::fromTriangles(const std::vector<VertexPN>& verts, const std::vector<u
     return m;
 }
 
+// 压缩顶点的索引网格：位置/法线/UV 由硬件按打包格式展开，位置再经常量属性反量化
+Mesh Mesh::fromPacked(const VertexPacked* verts, size_t vertexCount, const VertexDequant& dequant,
+                      const unsigned int* indices, size_t indexCount) {
+    Mesh m;
+    m.m_indexed = true;
+    m.m_elemCount = static_cast<GLsizei>(indexCount);
+    m.m_lods[0] = MeshLod{0, (uint32_t)indexCount, 0.0f};
+    m.m_vertexCount = vertexCount;
+    m.m_vertexBytes = vertexCount * sizeof(VertexPacked);
+    m.m_dequant = dequant;
+
+    glGenVertexArrays(1, &m.m_vao);
+    glGenBuffers(1, &m.m_vbo);
+    glGenBuffers(1, &m.m_ebo);
+
+    glBindVertexArray(m.m_vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m.m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m.m_vertexBytes, verts, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m.m_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indexCount * sizeof(unsigned int)), indices, GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(VertexPacked), (void*)offsetof(VertexPacked, pos));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(VertexPacked), (void*)offsetof(VertexPacked, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(VertexPacked), (void*)offsetof(VertexPacked, uv));
+
+    glBindVertexArray(0);
+    return m;
+}
+
 // 非索引三角形网格（无索引缓冲）
 Mesh Mesh::fromTrianglesNonIndexed(const std::vector<VertexPN>& verts) {
     Mesh m;
     m.m_indexed = false;
     m.m_elemCount = static_cast<GLsizei>(verts.size());
+    m.m_lods[0] = MeshLod{0, (uint32_t)verts.size(), 0.0f};
+    m.m_vertexCount = verts.size();
+    m.m_vertexBytes = verts.size() * sizeof(VertexPN);
 
     glGenVertexArrays(1, &m.m_vao);
     glGenBuffers(1, &m.m_vbo);
@@ -91,13 +150,85 @@ Mesh Mesh::fromTrianglesNonIndexed(const std::vector<VertexPN>& verts) {
     return m;
 }
 
+// 常量属性的当前值：只有网格写这两个位置，值不变时跳过
+static VertexDequant s_boundDequant;
+static bool s_dequantBound = false;
+
+// 设置位置反量化参数
+void Mesh::bindDequant() const {
+    if (s_dequantBound && s_boundDequant.offset == m_dequant.offset && s_boundDequant.scale == m_dequant.scale) return;
+    glVertexAttrib3fv(VERTEX_ATTR_POS_OFFSET, &m_dequant.offset.x);
+    glVertexAttrib3fv(VERTEX_ATTR_POS_SCALE, &m_dequant.scale.x);
+    s_boundDequant = m_dequant;
+    s_dequantBound = true;
+}
+
+// 设置 LOD 区间：越界的级别及其后的级别被丢弃
+void Mesh::setLods(const MeshLod* lods, int count) {
+    m_lodCount = 1;
+    m_lods[0] = MeshLod{0, (uint32_t)m_elemCount, 0.0f};
+    if (!m_indexed) return;
+    for (int i = 0; i < count && i < MAX_MESH_LODS; ++i) {
+        const MeshLod& l = lods[i];
+        if (l.indexCount == 0 || (uint64_t)l.firstIndex + l.indexCount > (uint64_t)m_elemCount) break;
+        m_lods[i] = l;
+        m_lodCount = i + 1;
+    }
+}
+
+// 计数：triangles 为实际提交的三角形，lodTrianglesSaved 为相对 0 级少提交的三角形
+void Mesh::countDraw(const MeshLod& l, uint64_t instances) const {
+    drawCounters().drawCalls++;
+    drawCounters().triangles += (uint64_t)(l.indexCount / 3) * instances;
+    drawCounters().lodTrianglesSaved += (uint64_t)((m_lods[0].indexCount - l.indexCount) / 3) * instances;
+    drawCounters().vertexBytes += (uint64_t)m_vertexBytes * instances;
+}
+
 // 绘制网格
-void Mesh::draw() const {
+void Mesh::draw(int lod) const {
+    const MeshLod& l = m_lods[clampLod(lod)];
+    countDraw(l, 1);
+    bindDequant();
     glBindVertexArray(m_vao);
     if (m_indexed) {
-        glDrawElements(GL_TRIANGLES, m_elemCount, GL_UNSIGNED_INT, nullptr);
+        glDrawElements(GL_TRIANGLES, (GLsizei)l.indexCount, GL_UNSIGNED_INT, (void*)(l.firstIndex * sizeof(unsigned int)));
     } else {
         glDrawArrays(GL_TRIANGLES, 0, m_elemCount);
     }
     glBindVertexArray(0);
 }
+
+// 实例化绘制：每次按偏移重新指向实例缓冲，使多个批次共用一个缓冲
+void Mesh::drawInstanced(GLuint instanceBuffer, size_t byteOffset, GLsizei count, int lod) const {
+    if (count <= 0) return;
+    const MeshLod& l = m_lods[clampLod(lod)];
+    countDraw(l, (uint64_t)count);
+
+    bindDequant();
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for (GLuint c = 0; c < 4; ++c) {
+        GLuint loc = INSTANCE_ATTR_MODEL + c;
+        glEnableVertexAttribArray(loc);
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+            (void*)(byteOffset + offsetof(InstanceData, model) + sizeof(glm::vec4) * c));
+        glVertexAttribDivisor(loc, 1);
+    }
+    glEnableVertexAttribArray(INSTANCE_ATTR_COLOR);
+    glVertexAttribPointer(INSTANCE_ATTR_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+        (void*)(byteOffset + offsetof(InstanceData, color)));
+    glVertexAttribDivisor(INSTANCE_ATTR_COLOR, 1);
+    glEnableVertexAttribArray(INSTANCE_ATTR_LAYER);
+    glVertexAttribPointer(INSTANCE_ATTR_LAYER, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+        (void*)(byteOffset + offsetof(InstanceData, layer)));
+    glVertexAttribDivisor(INSTANCE_ATTR_LAYER, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (m_indexed) {
+        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)l.indexCount, GL_UNSIGNED_INT,
+                                (void*)(l.firstIndex * sizeof(unsigned int)), count);
+    } else {
+        glDrawArraysInstanced(GL_TRIANGLES, 0, m_elemCount, count);
+    }
+    glBindVertexArray(0);
+}
@@ -0,0 +1,485 @@
+#include "MeshOptimizer.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace meshopt {
+
+namespace {
+
+// Forsyth 打分参数（原文推荐值）
+constexpr int SCORE_CACHE_SIZE = 32;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRI_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+float vertexScore(int cachePos, uint32_t valence) {
+    if (valence == 0) return -1.0f; // 已无待输出的三角形
+
+    float score = 0.0f;
+    if (cachePos >= 0) {
+        if (cachePos < 3) {
+            // 刚用过的三个顶点得分固定，避免总是沿同一条边生成长条
+            score = LAST_TRI_SCORE;
+        } else {
+            float x = 1.0f - (float)(cachePos - 3) / (float)(SCORE_CACHE_SIZE - 3);
+            score = std::pow(x, CACHE_DECAY_POWER);
+        }
+    }
+    // 剩余价数越少越优先，尽早收尾孤立的三角形
+    return score + VALENCE_BOOST_SCALE * std::pow((float)valence, -VALENCE_BOOST_POWER);
+}
+
+// FIFO 缓存模拟：时间戳只在未命中时前进，相差不超过容量即仍在缓存中
+struct FifoCache {
+    std::vector<uint32_t> stamp;
+    uint32_t time;
+    unsigned size;
+
+    FifoCache(size_t vertexCount, unsigned cacheSize) : stamp(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+    // 返回是否未命中
+    bool access(uint32_t v) {
+        if (time - stamp[v] <= size) return false;
+        stamp[v] = time++;
+        return true;
+    }
+
+    void reset() { time += size + 1; }
+};
+
+// 平面二次误差 Q(p) = pᵀAp + 2b·p + c，按三角形面积加权；w 为权重和，用于把误差归一为均方距离
+struct Quadric {
+    double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double w = 0.0;
+
+    // 平面 n·p + d = 0（n 为单位向量）
+    void addPlane(const glm::dvec3& n, double d, double weight) {
+        a00 += weight * n.x * n.x; a01 += weight * n.x * n.y; a02 += weight * n.x * n.z;
+        a11 += weight * n.y * n.y; a12 += weight * n.y * n.z; a22 += weight * n.z * n.z;
+        b0 += weight * n.x * d; b1 += weight * n.y * d; b2 += weight * n.z * d;
+        c += weight * d * d;
+        w += weight;
+    }
+
+    void add(const Quadric& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2;
+        c += q.c;
+        w += q.w;
+    }
+
+    double evaluate(const glm::vec3& p) const {
+        const double x = p.x, y = p.y, z = p.z;
+        const double r = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                         2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return std::max(r, 0.0);
+    }
+};
+
+} // namespace
+
+float acmr(const uint32_t* indices, size_t indexCount, size_t vertexCount, unsigned cacheSize) {
+    if (indexCount < 3) return 0.0f;
+    FifoCache cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (size_t i = 0; i < indexCount; ++i) misses += cache.access(indices[i]);
+    return (float)misses / (float)(indexCount / 3);
+}
+
+void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    const size_t triCount = indexCount / 3;
+    if (triCount < 2) return;
+
+    const std::vector<uint32_t> src(indices, indices + triCount * 3);
+
+    // 顶点 -> 三角形邻接表；live[v] 为尚未输出的三角形数，表中前 live[v] 项有效
+    std::vector<uint32_t> offset(vertexCount + 1, 0);
+    for (uint32_t v : src) offset[v + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) offset[v + 1] += offset[v];
+    std::vector<uint32_t> adj(src.size());
+    std::vector<uint32_t> live(vertexCount, 0);
+    for (size_t t = 0; t < triCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = src[t * 3 + k];
+            adj[offset[v] + live[v]++] = (uint32_t)t;
+        }
+    }
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vScore[v] = vertexScore(-1, live[v]);
+
+    std::vector<float> tScore(triCount);
+    std::vector<uint8_t> emitted(triCount, 0);
+    int best = 0;
+    for (size_t t = 0; t < triCount; ++t) {
+        tScore[t] = vScore[src[t * 3]] + vScore[src[t * 3 + 1]] + vScore[src[t * 3 + 2]];
+        if (tScore[t] > tScore[best]) best = (int)t;
+    }
+
+    uint32_t cache[SCORE_CACHE_SIZE + 3];
+    uint32_t next[SCORE_CACHE_SIZE + 3];
+    int cacheCount = 0;
+    size_t scan = 0;
+    size_t out = 0;
+
+    while (out < triCount * 3) {
+        if (best < 0) {
+            // 缓存中没有候选：按输入顺序取下一个未输出的三角形
+            while (emitted[scan]) ++scan;
+            best = (int)scan;
+        }
+
+        const size_t t = (size_t)best;
+        const uint32_t* tri = &src[t * 3];
+        emitted[t] = 1;
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = tri[k];
+            indices[out++] = v;
+
+            // 从邻接表中移除（与最后一个有效项交换）
+            uint32_t* list = &adj[offset[v]];
+            for (uint32_t i = 0; i < live[v]; ++i) {
+                if (list[i] == t) {
+                    list[i] = list[--live[v]];
+                    break;
+                }
+            }
+        }
+
+        // 本三角形的顶点移到缓存最前，其余顺延，超出容量的被挤出
+        int n = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (std::find(next, next + n, tri[k]) == next + n) next[n++] = tri[k];
+        }
+        for (int i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) next[n++] = v;
+        }
+        for (int i = 0; i < n; ++i) {
+            uint32_t v = next[i];
+            cachePos[v] = (i < SCORE_CACHE_SIZE) ? i : -1;
+            vScore[v] = vertexScore(cachePos[v], live[v]);
+        }
+
+        // 重新计算受影响三角形的得分，候选只取缓存中的顶点所连的三角形
+        best = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < n; ++i) {
+            uint32_t v = next[i];
+            const uint32_t* list = &adj[offset[v]];
+            for (uint32_t j = 0; j < live[v]; ++j) {
+                uint32_t a = list[j];
+                float s = vScore[src[a * 3]] + vScore[src[a * 3 + 1]] + vScore[src[a * 3 + 2]];
+                tScore[a] = s;
+                if (i < SCORE_CACHE_SIZE && s > bestScore) {
+                    bestScore = s;
+                    best = (int)a;
+                }
+            }
+        }
+
+        cacheCount = std::min(n, SCORE_CACHE_SIZE);
+        std::copy(next, next + cacheCount, cache);
+    }
+}
+
+void optimizeOverdraw(uint32_t* indices, size_t indexCount, const VertexPN* vertices, size_t vertexCount,
+                      float threshold) {
+    const size_t triCount = indexCount / 3;
+    if (triCount < 2) return;
+
+    const float baseAcmr = acmr(indices, triCount * 3, vertexCount);
+
+    // 硬边界：三个顶点都未命中的三角形（缓存已完全失效），在此切开不增加未命中
+    std::vector<size_t> hard;
+    {
+        FifoCache cache(vertexCount, CACHE_SIZE);
+        for (size_t t = 0; t < triCount; ++t) {
+            int misses = 0;
+            for (int k = 0; k < 3; ++k) misses += cache.access(indices[t * 3 + k]);
+            if (t == 0 || misses == 3) hard.push_back(t);
+        }
+        hard.push_back(triCount);
+    }
+
+    // 软边界：簇从起点起的局部 ACMR 已不高于 threshold × 该硬簇整体 ACMR 时在此切开，
+    // 之后的簇重新从空缓存开始（其代价计入下一簇的局部 ACMR）
+    std::vector<size_t> clusters;
+    {
+        FifoCache cache(vertexCount, CACHE_SIZE);
+        for (size_t h = 0; h + 1 < hard.size(); ++h) {
+            const size_t begin = hard[h];
+            const size_t end = hard[h + 1];
+            const float clusterAcmr = acmr(indices + begin * 3, (end - begin) * 3, vertexCount);
+
+            cache.reset();
+            size_t start = begin;
+            size_t misses = 0;
+            clusters.push_back(begin);
+            for (size_t t = begin; t < end; ++t) {
+                for (int k = 0; k < 3; ++k) misses += cache.access(indices[t * 3 + k]);
+                const size_t size = t + 1 - start;
+                if (t + 1 < end && (float)misses <= threshold * clusterAcmr * (float)size) {
+                    clusters.push_back(t + 1);
+                    start = t + 1;
+                    misses = 0;
+                    cache.reset();
+                }
+            }
+        }
+        clusters.push_back(triCount);
+    }
+    if (clusters.size() <= 2) return;
+
+    // 网格中心：面积加权的三角形重心
+    auto triCentroidArea = [&](size_t t, glm::vec3& centroid, glm::vec3& normal) {
+        const glm::vec3& a = vertices[indices[t * 3]].pos;
+        const glm::vec3& b = vertices[indices[t * 3 + 1]].pos;
+        const glm::vec3& c = vertices[indices[t * 3 + 2]].pos;
+        normal = glm::cross(b - a, c - a); // 长度为面积的两倍
+        centroid = (a + b + c) / 3.0f;
+        return glm::length(normal);
+    };
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triCount; ++t) {
+        glm::vec3 c, n;
+        float area = triCentroidArea(t, c, n);
+        meshCenter += c * area;
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) meshCenter /= meshArea;
+
+    // 簇越靠外且朝外，越可能遮挡其他簇，先画
+    struct Cluster {
+        size_t begin;
+        size_t end;
+        float sortKey;
+    };
+    std::vector<Cluster> order;
+    order.reserve(clusters.size() - 1);
+    for (size_t i = 0; i + 1 < clusters.size(); ++i) {
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = clusters[i]; t < clusters[i + 1]; ++t) {
+            glm::vec3 c, n;
+            float a = triCentroidArea(t, c, n);
+            centroid += c * a;
+            normal += n;
+            area += a;
+        }
+        float key = 0.0f;
+        float len = glm::length(normal);
+        if (area > 0.0f && len > 0.0f) key = glm::dot(centroid / area - meshCenter, normal / len);
+        order.push_back(Cluster{clusters[i], clusters[i + 1], key});
+    }
+    std::stable_sort(order.begin(), order.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> result;
+    result.reserve(triCount * 3);
+    for (const Cluster& c : order) {
+        result.insert(result.end(), indices + c.begin * 3, indices + c.end * 3);
+    }
+
+    // 簇划分只是近似约束，最终再核对一次缓存效率
+    if (acmr(result.data(), result.size(), vertexCount) <= baseAcmr * threshold + 1e-4f) {
+        std::copy(result.begin(), result.end(), indices);
+    }
+}
+
+size_t optimizeVertexFetch(VertexPN* vertices, uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    const uint32_t unused = ~0u;
+    std::vector<uint32_t> remap(vertexCount, unused);
+    std::vector<VertexPN> reordered;
+    reordered.reserve(vertexCount);
+
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t& r = remap[indices[i]];
+        if (r == unused) {
+            r = (uint32_t)reordered.size();
+            reordered.push_back(vertices[indices[i]]);
+        }
+        indices[i] = r;
+    }
+    std::copy(reordered.begin(), reordered.end(), vertices);
+    return reordered.size();
+}
+
+size_t simplify(uint32_t* destination, const uint32_t* indices, size_t indexCount, const VertexPN* vertices,
+                size_t vertexCount, size_t targetIndexCount, float maxError, float* resultError) {
+    std::vector<uint32_t> result(indices, indices + indexCount / 3 * 3);
+    const size_t target = targetIndexCount / 3 * 3;
+    float achieved = 0.0f;
+
+    // 同一位置的顶点归到代表顶点（排序后第一个）；一个位置有多个顶点即为属性接缝，锁定
+    std::vector<uint32_t> posOf(vertexCount);
+    std::vector<uint8_t> locked(vertexCount, 0); // 按代表顶点记录
+    {
+        std::vector<uint32_t> order(vertexCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            const glm::vec3& p = vertices[a].pos;
+            const glm::vec3& q = vertices[b].pos;
+            if (p.x != q.x) return p.x < q.x;
+            if (p.y != q.y) return p.y < q.y;
+            return p.z < q.z;
+        });
+        for (size_t i = 0; i < vertexCount;) {
+            size_t j = i + 1;
+            while (j < vertexCount && vertices[order[j]].pos == vertices[order[i]].pos) ++j;
+            for (size_t k = i; k < j; ++k) posOf[order[k]] = order[i];
+            if (j - i > 1) locked[order[i]] = 1;
+            i = j;
+        }
+    }
+
+    // 按位置统计有向边：没有反向边的是开放边界，同向出现多次的是非流形边，两端都锁定
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(result.size());
+        for (size_t t = 0; t < result.size(); t += 3) {
+            for (int k = 0; k < 3; ++k) {
+                const uint64_t a = posOf[result[t + k]];
+                const uint64_t b = posOf[result[t + (k + 1) % 3]];
+                edges.push_back(a << 32 | b);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const uint64_t e = edges[i];
+            const uint32_t a = (uint32_t)(e >> 32);
+            const uint32_t b = (uint32_t)e;
+            const bool repeated = (i > 0 && edges[i - 1] == e) || (i + 1 < edges.size() && edges[i + 1] == e);
+            const bool open = !std::binary_search(edges.begin(), edges.end(), (uint64_t)b << 32 | a);
+            if (repeated || open) locked[a] = locked[b] = 1;
+        }
+    }
+
+    // 每个位置的误差二次型：相邻三角形所在平面按面积累加
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t < result.size(); t += 3) {
+        const glm::dvec3 p0(vertices[result[t]].pos);
+        const glm::dvec3 p1(vertices[result[t + 1]].pos);
+        const glm::dvec3 p2(vertices[result[t + 2]].pos);
+        glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+        const double len = glm::length(n);
+        if (len <= 0.0) continue;
+        n /= len;
+        for (int k = 0; k < 3; ++k) quadrics[posOf[result[t + k]]].addPlane(n, -glm::dot(n, p0), 0.5 * len);
+    }
+
+    struct Collapse {
+        uint32_t from;
+        uint32_t to;
+        double error; // 均方距离
+    };
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<uint32_t> adjOffset(vertexCount + 1);
+    std::vector<uint32_t> adjFill;
+    std::vector<uint32_t> adj;
+    const double maxErrorSq = (double)maxError * (double)maxError;
+
+    // 把 from 移到 to 的位置后，周围未被删除的三角形不能翻转或退化
+    auto flips = [&](uint32_t from, uint32_t to) {
+        const glm::vec3& p0 = vertices[from].pos;
+        const glm::vec3& p1 = vertices[to].pos;
+        for (uint32_t j = adjOffset[from]; j < adjOffset[from + 1]; ++j) {
+            const uint32_t* tri = &result[(size_t)adj[j] * 3];
+            if (tri[0] == to || tri[1] == to || tri[2] == to) continue; // 折叠后被删除
+            const int k = tri[0] == from ? 0 : (tri[1] == from ? 1 : 2);
+            const glm::vec3& a = vertices[tri[(k + 1) % 3]].pos;
+            const glm::vec3& b = vertices[tri[(k + 2) % 3]].pos;
+            const glm::vec3 n0 = glm::cross(a - p0, b - p0);
+            const glm::vec3 n1 = glm::cross(a - p1, b - p1);
+            const float l0 = glm::length(n0);
+            if (l0 <= 0.0f) continue;
+            if (glm::dot(n0, n1) <= 0.25f * l0 * glm::length(n1)) return true;
+        }
+        return false;
+    };
+
+    // 分轮进行：每轮按误差从小到大挑互不相邻的折叠一起执行，再重建邻接
+    while (result.size() > target) {
+        const size_t triCount = result.size() / 3;
+
+        std::fill(adjOffset.begin(), adjOffset.end(), 0u);
+        for (uint32_t v : result) adjOffset[v + 1]++;
+        for (size_t v = 0; v < vertexCount; ++v) adjOffset[v + 1] += adjOffset[v];
+        adjFill.assign(adjOffset.begin(), adjOffset.end() - 1);
+        adj.resize(result.size());
+        for (size_t t = 0; t < triCount; ++t) {
+            for (int k = 0; k < 3; ++k) adj[adjFill[result[t * 3 + k]]++] = (uint32_t)t;
+        }
+
+        candidates.clear();
+        for (size_t t = 0; t < triCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t a = result[t * 3 + k];
+                const uint32_t b = result[t * 3 + (k + 1) % 3];
+                if (a == b) continue;
+                for (int dir = 0; dir < 2; ++dir) {
+                    const uint32_t from = dir ? b : a;
+                    const uint32_t to = dir ? a : b;
+                    if (locked[posOf[from]]) continue;
+                    Quadric q = quadrics[from]; // 未锁定的顶点即是自己位置的代表
+                    q.add(quadrics[posOf[to]]);
+                    candidates.push_back(Collapse{from, to, q.w > 0.0 ? q.evaluate(vertices[to].pos) / q.w : 0.0});
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::fill(touched.begin(), touched.end(), 0);
+        // 每轮只完成剩余量的 1/4：一轮里做得太多会把误差较大的折叠排在本可先做的小折叠之前
+        const size_t needed = std::max<size_t>((result.size() - target) / 3 / 4, 1);
+        size_t removed = 0;
+        size_t applied = 0;
+        for (const Collapse& c : candidates) {
+            if (removed >= needed || c.error > maxErrorSq) break;
+            if (touched[c.from] || touched[c.to] || flips(c.from, c.to)) continue;
+
+            remap[c.from] = c.to;
+            quadrics[posOf[c.to]].add(quadrics[c.from]);
+            achieved = std::max(achieved, (float)std::sqrt(c.error));
+            applied++;
+
+            // 一环内的顶点本轮不再移动，保证上面的翻转检查用到的位置仍然有效
+            for (uint32_t j = adjOffset[c.from]; j < adjOffset[c.from + 1]; ++j) {
+                const uint32_t* tri = &result[(size_t)adj[j] * 3];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+                if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) removed++;
+            }
+        }
+        if (applied == 0) break; // 剩余折叠都超出误差上限或会翻转三角形
+
+        size_t write = 0;
+        for (size_t t = 0; t < triCount; ++t) {
+            const uint32_t a = remap[result[t * 3]];
+            const uint32_t b = remap[result[t * 3 + 1]];
+            const uint32_t c = remap[result[t * 3 + 2]];
+            if (a == b || b == c || a == c) continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    std::copy(result.begin(), result.end(), destination);
+    if (resultError) *resultError = achieved;
+    return result.size();
+}
+
+} // namespace meshopt
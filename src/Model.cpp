@@ -1,15 +1,24 @@
 #include "Model.hpp"
 
+#include "Config.hpp"
+#include "MeshOptimizer.hpp"
+#include "ModelCache.hpp"
 #include "Util.hpp"
+#include "VertexCodec.hpp"
+#include "Vfs.hpp"
 
+#include <assimp/IOSystem.hpp>
 #include <assimp/Importer.hpp>
+#include <assimp/MemoryIOWrapper.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <assimp/material.h>
 
 #include <algorithm>
 #include <cfloat>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -23,9 +32,25 @@ static glm::mat4 aiToGlm(const aiMatrix4x4& m) {
     return r;
 }
 
-static Mesh processMesh(aiMesh* mesh, const glm::mat4& xform, AABB& aabb) {
-    std::vector<VertexPN> verts;
-    verts.reserve(mesh->mNumVertices);
+// 网格在 ModelData 存储中的位置（存储增长期间指针会失效，最后统一换算）
+struct MeshRange {
+    size_t firstVertex = 0;
+    size_t vertexCount = 0;
+    size_t firstIndex = 0;
+    size_t indexCount = 0;
+    unsigned int material = 0;
+    MeshLod lods[MAX_MESH_LODS]; // 相对 firstIndex
+    int lodCount = 0;
+};
+
+static void processMesh(aiMesh* mesh, const glm::mat4& xform, ModelData& data, std::vector<MeshRange>& ranges) {
+    std::vector<VertexPN>& verts = data.vertexStorage;
+    MeshRange range;
+    range.firstVertex = verts.size();
+    range.vertexCount = mesh->mNumVertices;
+    range.material = mesh->mMaterialIndex;
+    verts.reserve(verts.size() + mesh->mNumVertices);
+    AABB& aabb = data.aabb;
 
     glm::mat3 nmat = glm::transpose(glm::inverse(glm::mat3(xform)));
 
@@ -55,31 +80,214 @@ static Mesh processMesh(aiMesh* mesh, const glm::mat4& xform, AABB& aabb) {
         verts.push_back(v);
     }
 
-    std::vector<unsigned int> indices;
-    indices.reserve(mesh->mNumFaces * 3);
+    std::vector<uint32_t>& indices = data.indexStorage;
+    range.firstIndex = indices.size();
+    indices.reserve(indices.size() + mesh->mNumFaces * 3);
     for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
         const aiFace& f = mesh->mFaces[i];
         for (unsigned int j = 0; j < f.mNumIndices; ++j) indices.push_back(f.mIndices[j]);
     }
+    range.indexCount = indices.size() - range.firstIndex;
 
-    return Mesh::fromTriangles(verts, indices);
+    ranges.push_back(range);
 }
 
-static void processNode(aiNode* node, const aiScene* scene, const glm::mat4& parent, std::vector<Mesh>& out, AABB& aabb) {
+static void processNode(aiNode* node, const aiScene* scene, const glm::mat4& parent, ModelData& data, std::vector<MeshRange>& ranges) {
     glm::mat4 local = aiToGlm(node->mTransformation);
     glm::mat4 xform = parent * local;
 
     for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
         aiMesh* m = scene->mMeshes[node->mMeshes[i]];
-        out.push_back(processMesh(m, xform, aabb));
+        processMesh(m, xform, data, ranges);
     }
 
     for (unsigned int i = 0; i < node->mNumChildren; ++i) {
-        processNode(node->mChildren[i], scene, xform, out, aabb);
+        processNode(node->mChildren[i], scene, xform, data, ranges);
+    }
+}
+
+// 合并同材质的网格：整个模型共用一张反照率，同材质网格的绘制状态完全相同，合并后每个材质只需一次绘制
+static void mergeMeshesByMaterial(ModelData& data, std::vector<MeshRange>& ranges) {
+    if (ranges.size() < 2) return;
+
+    std::vector<VertexPN> verts;
+    std::vector<uint32_t> indices;
+    verts.reserve(data.vertexStorage.size());
+    indices.reserve(data.indexStorage.size());
+
+    std::vector<MeshRange> merged;
+    std::vector<bool> taken(ranges.size(), false);
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (taken[i]) continue;
+        MeshRange m;
+        m.firstVertex = verts.size();
+        m.firstIndex = indices.size();
+        m.material = ranges[i].material;
+        for (size_t j = i; j < ranges.size(); ++j) {
+            const MeshRange& r = ranges[j];
+            if (taken[j] || r.material != m.material) continue;
+            taken[j] = true;
+
+            const uint32_t base = (uint32_t)(verts.size() - m.firstVertex);
+            verts.insert(verts.end(), data.vertexStorage.begin() + (ptrdiff_t)r.firstVertex,
+                         data.vertexStorage.begin() + (ptrdiff_t)(r.firstVertex + r.vertexCount));
+            for (size_t k = 0; k < r.indexCount; ++k) indices.push_back(data.indexStorage[r.firstIndex + k] + base);
+        }
+        m.vertexCount = verts.size() - m.firstVertex;
+        m.indexCount = indices.size() - m.firstIndex;
+        merged.push_back(m);
+    }
+
+    data.vertexStorage.swap(verts);
+    data.indexStorage.swap(indices);
+    ranges.swap(merged);
+}
+
+// 导入期网格优化：顶点缓存排序 -> 过度绘制簇排序 -> 顶点读取重排，并报告优化前后的 ACMR
+static void optimizeMeshes(const std::string& path, ModelData& data, std::vector<MeshRange>& ranges, size_t sourceMeshes) {
+    double trisTotal = 0.0, missesBefore = 0.0, missesAfter = 0.0;
+    size_t verticesBefore = 0, verticesAfter = 0;
+    for (MeshRange& r : ranges) {
+        verticesBefore += r.vertexCount;
+        if (r.indexCount < 3 || r.indexCount % 3 != 0) {
+            verticesAfter += r.vertexCount;
+            continue;
+        }
+        uint32_t* idx = data.indexStorage.data() + r.firstIndex;
+        VertexPN* verts = data.vertexStorage.data() + r.firstVertex;
+        const double tris = (double)(r.indexCount / 3);
+
+        missesBefore += meshopt::acmr(idx, r.indexCount, r.vertexCount) * tris;
+        meshopt::optimizeVertexCache(idx, r.indexCount, r.vertexCount);
+        meshopt::optimizeOverdraw(idx, r.indexCount, verts, r.vertexCount);
+        r.vertexCount = meshopt::optimizeVertexFetch(verts, idx, r.indexCount, r.vertexCount);
+        missesAfter += meshopt::acmr(idx, r.indexCount, r.vertexCount) * tris;
+
+        trisTotal += tris;
+        verticesAfter += r.vertexCount;
+    }
+    if (trisTotal <= 0.0) return;
+
+    char buf[256];
+    std::snprintf(buf, sizeof(buf), "Optimized model: %s meshes=%zu->%zu tris=%.0f verts=%zu->%zu ACMR=%.3f->%.3f",
+        path.c_str(), sourceMeshes, ranges.size(), trisTotal, verticesBefore, verticesAfter,
+        missesBefore / trisTotal, missesAfter / trisTotal);
+    util::logInfo(buf);
+}
+
+// 生成 LOD：从完整网格按 QEM 简化出较粗的级别，各级索引依次接在完整网格之后并分别做顶点缓存排序
+static void generateLods(const std::string& path, ModelData& data, std::vector<MeshRange>& ranges) {
+    std::vector<uint32_t> indices;
+    indices.reserve(data.indexStorage.size() * 2);
+    std::vector<uint32_t> scratch;
+    float worstError[MAX_MESH_LODS] = {}; // 相对网格最大跨度
+    int levels = 1;
+
+    for (MeshRange& r : ranges) {
+        const uint32_t* src = data.indexStorage.data() + r.firstIndex;
+        const VertexPN* verts = data.vertexStorage.data() + r.firstVertex;
+        const size_t first = indices.size();
+        indices.insert(indices.end(), src, src + r.indexCount);
+        r.lods[0] = MeshLod{0, (uint32_t)r.indexCount, 0.0f};
+        r.lodCount = 1;
+
+        glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+        for (size_t i = 0; i < r.vertexCount; ++i) {
+            lo = glm::min(lo, verts[i].pos);
+            hi = glm::max(hi, verts[i].pos);
+        }
+        const glm::vec3 size = hi - lo;
+        const float extent = r.vertexCount ? std::max(size.x, std::max(size.y, size.z)) : 0.0f;
+
+        size_t prev = r.indexCount;
+        scratch.resize(r.indexCount);
+        for (int level = 1; level < std::min(cfg::MODEL_LOD_LEVELS, MAX_MESH_LODS); ++level) {
+            if (r.indexCount < 3 || r.indexCount % 3 != 0 || extent <= 0.0f) break;
+            const size_t target = (size_t)((double)prev * cfg::MODEL_LOD_REDUCTION);
+            float err = 0.0f;
+            const size_t n = meshopt::simplify(scratch.data(), src, r.indexCount, verts, r.vertexCount, target,
+                                               cfg::MODEL_LOD_MAX_ERROR * extent * (float)level, &err);
+            if (n == 0 || (double)n > 0.8 * (double)prev) break;
+
+            meshopt::optimizeVertexCache(scratch.data(), n, r.vertexCount);
+            r.lods[level] = MeshLod{(uint32_t)(indices.size() - first), (uint32_t)n, err};
+            r.lodCount = level + 1;
+            indices.insert(indices.end(), scratch.begin(), scratch.begin() + (ptrdiff_t)n);
+            worstError[level] = std::max(worstError[level], err / extent);
+            prev = n;
+        }
+        r.firstIndex = first;
+        r.indexCount = indices.size() - first;
+        levels = std::max(levels, r.lodCount);
+    }
+    data.indexStorage.swap(indices);
+    if (levels < 2) return;
+
+    // 各级三角形总数（级数不足的网格按其最粗一级计）
+    std::string tris, errs;
+    for (int level = 0; level < levels; ++level) {
+        size_t n = 0;
+        for (const MeshRange& r : ranges) n += r.lods[std::min(level, r.lodCount - 1)].indexCount / 3;
+        tris += (level ? "/" : "") + std::to_string(n);
+        if (level) {
+            char e[32];
+            std::snprintf(e, sizeof(e), "%s%.2f%%", level > 1 ? "/" : "", 100.0 * worstError[level]);
+            errs += e;
+        }
     }
+    util::logInfo("Generated LODs: " + path + " tris=" + tris + " max_err=" + errs + " of extent");
 }
 
-static bool tryLoadAlbedoFromMaterial(Texture2D& out, const aiScene* scene, aiMaterial* mat, const std::string& modelPath) {
+// 生成网格视图；开启顶点打包时，往返误差在界内的网格改用 16 字节压缩格式
+static void buildMeshViews(const std::string& path, ModelData& data, const std::vector<MeshRange>& ranges) {
+    data.packedStorage.clear();
+    if (cfg::VERTEX_PACKING) data.packedStorage.reserve(data.vertexStorage.size()); // 不再扩容，指针保持有效
+
+    size_t packedMeshes = 0, fullBytes = 0, gpuBytes = 0;
+    vertexcodec::PackError worst;
+    for (const auto& r : ranges) {
+        MeshData m;
+        const VertexPN* src = data.vertexStorage.data() + r.firstVertex;
+        m.vertices = src;
+        m.vertexCount = (uint32_t)r.vertexCount;
+        m.indices = data.indexStorage.data() + r.firstIndex;
+        m.indexCount = (uint32_t)r.indexCount;
+        std::copy(r.lods, r.lods + r.lodCount, m.lods);
+        m.lodCount = (uint32_t)r.lodCount;
+
+        if (cfg::VERTEX_PACKING && r.vertexCount > 0) {
+            const size_t first = data.packedStorage.size();
+            data.packedStorage.resize(first + r.vertexCount);
+            vertexcodec::PackError err;
+            vertexcodec::pack(src, r.vertexCount, data.packedStorage.data() + first, m.dequant, err);
+            if (err.withinBounds()) {
+                m.format = VertexFormat::Packed;
+                m.vertices = data.packedStorage.data() + first;
+                worst.pos = std::max(worst.pos, err.pos);
+                worst.normalDeg = std::max(worst.normalDeg, err.normalDeg);
+                worst.uv = std::max(worst.uv, err.uv);
+                packedMeshes++;
+            } else {
+                data.packedStorage.resize(first);
+                m.dequant = VertexDequant{};
+            }
+        }
+        fullBytes += r.vertexCount * sizeof(VertexPN);
+        gpuBytes += r.vertexCount * vertexStride(m.format);
+        data.meshes.push_back(m);
+    }
+
+    if (fullBytes == 0) return;
+    char buf[320];
+    std::snprintf(buf, sizeof(buf),
+        "Packed vertices: %s meshes=%zu/%zu vertex_bytes=%zu->%zu (-%.0f%%) max_err pos=%.2e normal=%.3fdeg uv=%.2e",
+        path.c_str(), packedMeshes, ranges.size(), fullBytes, gpuBytes,
+        100.0 * (1.0 - (double)gpuBytes / (double)fullBytes), worst.pos, worst.normalDeg, worst.uv);
+    util::logInfo(buf);
+}
+
+// 取材质的反照率纹理源数据（嵌入的压缩图片/原始像素或外部图片文件），稍后在主线程解码上传
+static bool tryLoadAlbedoFromMaterial(ModelData& out, const aiScene* scene, aiMaterial* mat, const std::string& modelPath) {
     aiString texPath;
 
     // glTF2 通常使用 BASE_COLOR，也可能用 DIFFUSE。
@@ -100,15 +308,12 @@ static bool tryLoadAlbedoFromMaterial(Texture2D& out, const aiScene* scene, aiMa
 
             if (t->mHeight == 0) {
                 // 压缩字节存于 pcData，长度为 mWidth
-                out = Texture2D::fromMemory(
-                    reinterpret_cast<const unsigned char*>(t->pcData),
-                    (int)t->mWidth,
-                    true
-                );
-                return out.valid();
+                const unsigned char* bytes = reinterpret_cast<const unsigned char*>(t->pcData);
+                out.albedoStorage.assign(bytes, bytes + t->mWidth);
+                out.albedo.kind = AlbedoKind::Encoded;
             } else {
                 // 原始像素存为 aiTexel (BGRA)
-                std::vector<unsigned char> pixels;
+                std::vector<unsigned char>& pixels = out.albedoStorage;
                 pixels.resize((size_t)t->mWidth * (size_t)t->mHeight * 4);
 
                 for (unsigned int i = 0; i < t->mWidth * t->mHeight; ++i) {
@@ -119,9 +324,11 @@ static bool tryLoadAlbedoFromMaterial(Texture2D& out, const aiScene* scene, aiMa
                     pixels[i * 4 + 3] = px.a;
                 }
 
-                out = Texture2D::fromPixels(pixels.data(), (int)t->mWidth, (int)t->mHeight, 4, true);
-                return out.valid();
+                out.albedo.kind = AlbedoKind::Rgba;
+                out.albedo.width = (int)t->mWidth;
+                out.albedo.height = (int)t->mHeight;
             }
+            return !out.albedoStorage.empty();
         }
         return false;
     }
@@ -131,13 +338,43 @@ static bool tryLoadAlbedoFromMaterial(Texture2D& out, const aiScene* scene, aiMa
     auto slash = modelDir.find_last_of("/\\");
     if (slash != std::string::npos) modelDir = modelDir.substr(0, slash);
 
-    std::string full = modelDir + "/" + tpath;
-    out = Texture2D::fromFile(full, true);
-    return out.valid();
+    vfs::File file = vfs::open(modelDir + "/" + tpath);
+    if (!file.valid()) return false;
+    out.albedoStorage.assign(file.data(), file.data() + file.size());
+    out.albedo.kind = AlbedoKind::Encoded;
+    return !out.albedoStorage.empty();
 }
 
-Model::Model(const std::string& path) {
+// 让 Assimp 经 VFS 读取模型文件及其引用的外部文件（.bin、.mtl 等）
+class VfsIOStream : public Assimp::MemoryIOStream {
+public:
+    // 基类只保存指针，数据由 m_file 持有（映射区或自有缓冲，移动后地址不变）
+    explicit VfsIOStream(vfs::File file)
+        : MemoryIOStream(file.data(), file.size()), m_file(std::move(file)) {}
+
+private:
+    vfs::File m_file;
+};
+
+class VfsIOSystem : public Assimp::IOSystem {
+public:
+    bool Exists(const char* path) const override { return vfs::exists(path); }
+    char getOsSeparator() const override { return '/'; }
+
+    Assimp::IOStream* Open(const char* path, const char* mode) override {
+        if (mode && (std::strchr(mode, 'w') || std::strchr(mode, 'a'))) return nullptr;
+        vfs::File file = vfs::open(path);
+        if (!file.valid()) return nullptr;
+        return new VfsIOStream(std::move(file));
+    }
+
+    void Close(Assimp::IOStream* stream) override { delete stream; }
+};
+
+// 用 Assimp 导入模型到 CPU 数据
+static bool importModel(const std::string& path, ModelData& data) {
     Assimp::Importer importer;
+    importer.SetIOHandler(new VfsIOSystem()); // 由 importer 负责释放
     const aiScene* scene = importer.ReadFile(
         path,
         aiProcess_Triangulate |
@@ -147,18 +384,24 @@ Model::Model(const std::string& path) {
 
     if (!scene || !scene->mRootNode) {
         util::logWarn(std::string("Assimp failed to load model: ") + path + " (" + importer.GetErrorString() + ")");
-        return;
+        return false;
     }
 
-    AABB aabb;
-    aabb.min = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
-    aabb.max = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    data.aabb.min = glm::vec3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    data.aabb.max = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
 
-    processNode(scene->mRootNode, scene, glm::mat4(1.0f), m_meshes, aabb);
+    std::vector<MeshRange> ranges;
+    processNode(scene->mRootNode, scene, glm::mat4(1.0f), data, ranges);
 
-    if (!m_meshes.empty()) {
-        m_aabb = aabb;
+    const size_t sourceMeshes = ranges.size();
+    mergeMeshesByMaterial(data, ranges);
+    optimizeMeshes(path, data, ranges, sourceMeshes);
+    generateLods(path, data, ranges);
+
+    if (ranges.empty()) {
+        data.aabb = AABB{{0,0,0},{0,0,0}};
     }
+    buildMeshViews(path, data, ranges);
 
     // ---- 快速路径：为整个模型加载一张反照率纹理 ----
     // （棋盘通常只有一个材质。）
@@ -172,21 +415,22 @@ Model::Model(const std::string& path) {
             aiMaterial* mat = scene->mMaterials[matIndex];
             if (!mat) continue;
 
-            if (tryLoadAlbedoFromMaterial(m_albedo, scene, mat, path)) {
-                util::logInfo("Loaded board albedo texture from model material.");
+            if (tryLoadAlbedoFromMaterial(data, scene, mat, path)) {
+                data.albedo.bytes = data.albedoStorage.data();
+                data.albedo.size = data.albedoStorage.size();
                 albedoLoaded = true;
                 break;
             }
         }
     }
-
     if (!albedoLoaded) {
-        util::logWarn("No albedo/diffuse texture found in model material (board will render with solid color).");
+        data.albedo = AlbedoData{};
+        data.albedoStorage.clear();
     }
 
     // ---- 生成建议变换：XZ 居中，底部对齐 y=0，缩放到合适大小 ----
-    if (!m_meshes.empty()) {
-        const AABB a = m_aabb;
+    if (!data.meshes.empty()) {
+        const AABB a = data.aabb;
         glm::vec3 size = a.max - a.min;
         glm::vec3 center = 0.5f * (a.min + a.max);
 
@@ -201,14 +445,142 @@ Model::Model(const std::string& path) {
 
         glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(s));
 
-        m_suggested = S * T; // 先平移后缩放
+        data.suggested = S * T; // 先平移后缩放
     }
+    return true;
+}
 
+bool Model::loadData(const std::string& path, ModelData& out) {
+    if (modelcache::load(path, out)) return true;
+
+    out = ModelData{};
+    if (!importModel(path, out)) return false;
+    if (!out.meshes.empty()) modelcache::write(path, out);
+    return true;
+}
+
+bool Model::decodeAlbedo(ModelData& data) {
+    AlbedoData& a = data.albedo;
+    if (a.kind != AlbedoKind::Encoded) return true;
+
+    std::vector<unsigned char> rgba;
+    int w = 0, h = 0;
+    if (!Texture2D::decodeRgba(a.bytes, (int)a.size, rgba, w, h)) {
+        util::logWarn("Failed to decode embedded texture (stb_image).");
+        a = AlbedoData{};
+        return false;
+    }
+    data.albedoStorage.swap(rgba);
+    a.kind = AlbedoKind::Rgba;
+    a.width = w;
+    a.height = h;
+    a.bytes = data.albedoStorage.data();
+    a.size = data.albedoStorage.size();
+    return true;
+}
+
+static uint64_t meshHash(const MeshData& m) {
+    uint64_t h = contentHash(&m.format, sizeof(m.format));
+    h = contentHash(&m.dequant, sizeof(m.dequant), h);
+    h = contentHash(m.vertices, (size_t)m.vertexCount * vertexStride(m.format), h);
+    h = contentHash(m.indices, (size_t)m.indexCount * sizeof(uint32_t), h);
+    return contentHash(m.lods, sizeof(MeshLod) * m.lodCount, h);
+}
+
+static uint64_t albedoHash(const AlbedoData& a) {
+    uint64_t h = contentHash(&a.kind, sizeof(a.kind));
+    h = contentHash(&a.width, sizeof(a.width), h);
+    h = contentHash(&a.height, sizeof(a.height), h);
+    return contentHash(a.bytes, a.size, h);
+}
+
+void Model::hashContent(ModelData& data) {
+    for (auto& m : data.meshes) {
+        if (!m.hash) m.hash = meshHash(m);
+    }
+    AlbedoData& a = data.albedo;
+    if (a.kind != AlbedoKind::None && !a.hash) a.hash = albedoHash(a);
+}
+
+// 由网格数据创建 GL 网格
+static Mesh createMesh(const MeshData& m) {
+    Mesh mesh = m.format == VertexFormat::Packed
+        ? Mesh::fromPacked(static_cast<const VertexPacked*>(m.vertices), m.vertexCount, m.dequant, m.indices, m.indexCount)
+        : Mesh::fromRaw(static_cast<const VertexPN*>(m.vertices), m.vertexCount, m.indices, m.indexCount);
+    if (m.lodCount > 0) mesh.setLods(m.lods, (int)m.lodCount);
+    return mesh;
+}
+
+// 由反照率数据创建纹理：Rgba 在有 streamer 时分帧上传
+static Texture2D createAlbedo(const AlbedoData& a, TextureStreamer* streamer) {
+    if (a.kind == AlbedoKind::Encoded) {
+        return Texture2D::fromMemory(a.bytes, (int)a.size, true);
+    } else if (a.kind == AlbedoKind::Rgba && streamer) {
+        return Texture2D::fromPixelsAsync(*streamer, std::vector<unsigned char>(a.bytes, a.bytes + a.size),
+                                          a.width, a.height, true);
+    } else if (a.kind == AlbedoKind::Rgba) {
+        return Texture2D::fromPixels(a.bytes, a.width, a.height, 4, true);
+    }
+    return Texture2D();
+}
+
+Model::Model(const ModelData& data, ResourceManager* resources) {
+    m_meshes.reserve(data.meshes.size());
+    for (const auto& m : data.meshes) {
+        if (resources) {
+            m_meshes.push_back(resources->acquireMesh(m.hash ? m.hash : meshHash(m), [&] { return createMesh(m); }));
+        } else {
+            m_meshes.push_back(std::make_shared<const Mesh>(createMesh(m)));
+        }
+        m_lodCount = std::max(m_lodCount, m_meshes.back()->lodCount());
+    }
+    if (!m_meshes.empty()) {
+        m_aabb = data.aabb;
+        m_suggested = data.suggested;
+    }
+
+    const AlbedoData& a = data.albedo;
+    if (a.kind != AlbedoKind::None && resources) {
+        m_albedo = resources->acquireTexture(a.hash ? a.hash : albedoHash(a), ResourceCategory::ModelTexture, true,
+                                             [&] { return createAlbedo(a, resources->streamer()); });
+    } else if (a.kind != AlbedoKind::None) {
+        m_albedo = TextureRef(std::make_shared<const Texture2D>(createAlbedo(a, nullptr)));
+    }
+}
+
+Model::Model(const std::string& path) {
+    ModelData data;
+    if (!loadData(path, data)) return;
+    *this = Model(data);
     util::logInfo(std::string("Loaded model: ") + path + " meshes=" + std::to_string(m_meshes.size()));
 }
 
-void Model::draw() const {
+size_t Model::vertexBytes() const {
+    size_t n = 0;
+    for (const auto& m : m_meshes) n += m->vertexBytes();
+    return n;
+}
+
+size_t Model::vertexCount() const {
+    size_t n = 0;
+    for (const auto& m : m_meshes) n += m->vertexCount();
+    return n;
+}
+
+float Model::lodError(int lod) const {
+    float e = 0.0f;
+    for (const auto& m : m_meshes) e = std::max(e, m->lod(lod).error);
+    return e;
+}
+
+void Model::draw(int lod) const {
+    for (const auto& m : m_meshes) {
+        m->draw(lod);
+    }
+}
+
+void Model::drawInstanced(GLuint instanceBuffer, size_t byteOffset, GLsizei count, int lod) const {
     for (const auto& m : m_meshes) {
-        m.draw();
+        m->drawInstanced(instanceBuffer, byteOffset, count, lod);
     }
 }
@@ -0,0 +1,277 @@
+#include "ModelCache.hpp"
+
+#include "Config.hpp"
+#include "Util.hpp"
+#include "Vfs.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char CACHE_MAGIC[4] = {'X', 'Q', 'M', 'C'};
+constexpr uint32_t CACHE_VERSION = 4; // 2：导入期网格合并与优化；3：按网格的顶点格式；4：LOD 区间
+constexpr size_t CACHE_ALIGN = 16;
+
+struct ModelCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+    uint32_t meshCount;
+    uint32_t vertexStride; // sizeof(VertexPN)，布局变化时缓存自动失效
+    uint32_t albedoKind;
+    int32_t albedoWidth;
+    int32_t albedoHeight;
+    uint32_t flags; // CACHE_FLAG_*：导入时的处理选项，与当前配置不同则重新导入
+    uint64_t albedoOffset;
+    uint64_t albedoSize;
+    float aabbMin[3];
+    float aabbMax[3];
+    float suggested[16];
+};
+static_assert(sizeof(ModelCacheHeader) == 160, "ModelCacheHeader must have no implicit padding");
+
+struct ModelCacheMesh {
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t vertexFormat; // VertexFormat
+    uint32_t pad0;
+    float dequantOffset[3];
+    float dequantScale[3];
+    uint32_t lodCount; // 0 表示只有完整网格
+    uint32_t lodFirstIndex[MAX_MESH_LODS];
+    uint32_t lodIndexCount[MAX_MESH_LODS];
+    float lodError[MAX_MESH_LODS];
+};
+static_assert(sizeof(ModelCacheMesh) == 60 + 12 * MAX_MESH_LODS, "ModelCacheMesh must have no implicit padding");
+
+constexpr uint32_t CACHE_FLAG_VERTEX_PACKING = 1u << 0;
+
+uint32_t currentFlags() {
+    // LOD 级数与简化参数也决定缓存内容
+    uint32_t flags = cfg::VERTEX_PACKING ? CACHE_FLAG_VERTEX_PACKING : 0u;
+    flags |= (uint32_t)cfg::MODEL_LOD_LEVELS << 8;
+    flags |= (uint32_t)(cfg::MODEL_LOD_REDUCTION * 100.0f + 0.5f) << 16;
+    flags |= (uint32_t)(cfg::MODEL_LOD_MAX_ERROR * 1000.0f + 0.5f) << 24;
+    return flags;
+}
+
+// 源文件身份：大小 + 修改时间（哈希按需计算）；源文件经 VFS 读取，包内条目的修改时间在打包时记录
+using SourceStamp = vfs::Stat;
+
+bool stampSource(const std::string& path, SourceStamp& out) {
+    return vfs::stat(path, out);
+}
+
+// FNV-1a 64 位，对整个源文件计算
+bool hashSource(const std::string& path, uint64_t& out) {
+    vfs::File f = vfs::open(path);
+    if (!f.valid()) return false;
+    uint64_t h = 1469598103934665603ull;
+    const unsigned char* p = f.data();
+    for (size_t i = 0, n = f.size(); i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    out = h;
+    return true;
+}
+
+size_t alignUp(size_t v) {
+    return (v + CACHE_ALIGN - 1) & ~(CACHE_ALIGN - 1);
+}
+
+bool inRange(uint64_t offset, uint64_t bytes, size_t fileSize) {
+    return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+} // namespace
+
+namespace modelcache {
+
+std::string cachePath(const std::string& sourcePath) {
+    std::string name = sourcePath;
+    for (char& c : name) {
+        if (c == '/' || c == '\\' || c == ':') c = '_';
+    }
+    return cfg::MODEL_CACHE_DIR + "/" + name + ".xqm";
+}
+
+bool load(const std::string& sourcePath, ModelData& out) {
+    const std::string path = cachePath(sourcePath);
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    const size_t fileSize = file.size();
+    if (fileSize < sizeof(ModelCacheHeader)) return false;
+
+    ModelCacheHeader h;
+    std::memcpy(&h, file.data(), sizeof(h));
+    if (std::memcmp(h.magic, CACHE_MAGIC, 4) != 0 || h.version != CACHE_VERSION ||
+        h.vertexStride != sizeof(VertexPN) || h.flags != currentFlags()) {
+        return false;
+    }
+
+    SourceStamp stamp;
+    if (!stampSource(sourcePath, stamp) || stamp.size != h.sourceSize) {
+        util::logInfo("Model cache stale: " + path);
+        return false;
+    }
+    if (stamp.mtime != h.sourceMtime) {
+        uint64_t hash = 0;
+        if (!hashSource(sourcePath, hash) || hash != h.sourceHash) {
+            util::logInfo("Model cache stale: " + path);
+            return false;
+        }
+    }
+
+    const uint64_t tableBytes = (uint64_t)h.meshCount * sizeof(ModelCacheMesh);
+    if (!inRange(sizeof(ModelCacheHeader), tableBytes, fileSize)) return false;
+
+    std::vector<MeshData> meshes;
+    meshes.reserve(h.meshCount);
+    for (uint32_t i = 0; i < h.meshCount; ++i) {
+        ModelCacheMesh m;
+        std::memcpy(&m, file.data() + sizeof(ModelCacheHeader) + i * sizeof(ModelCacheMesh), sizeof(m));
+        if (m.vertexFormat != (uint32_t)VertexFormat::Full && m.vertexFormat != (uint32_t)VertexFormat::Packed) return false;
+        const VertexFormat format = (VertexFormat)m.vertexFormat;
+        uint64_t vbytes = (uint64_t)m.vertexCount * vertexStride(format);
+        uint64_t ibytes = (uint64_t)m.indexCount * sizeof(uint32_t);
+        if (!inRange(m.vertexOffset, vbytes, fileSize) || !inRange(m.indexOffset, ibytes, fileSize) ||
+            (m.vertexOffset % CACHE_ALIGN) != 0 || (m.indexOffset % CACHE_ALIGN) != 0) {
+            return false;
+        }
+
+        MeshData md;
+        md.format = format;
+        md.vertices = file.data() + m.vertexOffset;
+        md.vertexCount = m.vertexCount;
+        md.dequant.offset = glm::vec3(m.dequantOffset[0], m.dequantOffset[1], m.dequantOffset[2]);
+        md.dequant.scale = glm::vec3(m.dequantScale[0], m.dequantScale[1], m.dequantScale[2]);
+        md.indices = reinterpret_cast<const uint32_t*>(file.data() + m.indexOffset);
+        md.indexCount = m.indexCount;
+        if (m.lodCount > (uint32_t)MAX_MESH_LODS) return false;
+        for (uint32_t l = 0; l < m.lodCount; ++l) {
+            if ((uint64_t)m.lodFirstIndex[l] + m.lodIndexCount[l] > m.indexCount) return false;
+            md.lods[l] = MeshLod{m.lodFirstIndex[l], m.lodIndexCount[l], m.lodError[l]};
+        }
+        md.lodCount = m.lodCount;
+        meshes.push_back(md);
+    }
+
+    AlbedoData albedo;
+    albedo.kind = (AlbedoKind)h.albedoKind;
+    if (albedo.kind != AlbedoKind::None) {
+        if (!inRange(h.albedoOffset, h.albedoSize, fileSize)) return false;
+        albedo.width = h.albedoWidth;
+        albedo.height = h.albedoHeight;
+        albedo.bytes = file.data() + h.albedoOffset;
+        albedo.size = (size_t)h.albedoSize;
+    }
+
+    out = ModelData{};
+    out.meshes = std::move(meshes);
+    out.aabb.min = glm::vec3(h.aabbMin[0], h.aabbMin[1], h.aabbMin[2]);
+    out.aabb.max = glm::vec3(h.aabbMax[0], h.aabbMax[1], h.aabbMax[2]);
+    std::memcpy(&out.suggested[0][0], h.suggested, sizeof(h.suggested));
+    out.albedo = albedo;
+    out.file = std::move(file);
+    return true;
+}
+
+bool write(const std::string& sourcePath, const ModelData& data) {
+    SourceStamp stamp;
+    uint64_t hash = 0;
+    if (!stampSource(sourcePath, stamp) || !hashSource(sourcePath, hash)) return false;
+
+    ModelCacheHeader h{};
+    std::memcpy(h.magic, CACHE_MAGIC, 4);
+    h.version = CACHE_VERSION;
+    h.sourceSize = stamp.size;
+    h.sourceMtime = stamp.mtime;
+    h.sourceHash = hash;
+    h.meshCount = (uint32_t)data.meshes.size();
+    h.vertexStride = sizeof(VertexPN);
+    h.albedoKind = (uint32_t)data.albedo.kind;
+    h.albedoWidth = data.albedo.width;
+    h.albedoHeight = data.albedo.height;
+    h.flags = currentFlags();
+    for (int i = 0; i < 3; ++i) {
+        h.aabbMin[i] = data.aabb.min[i];
+        h.aabbMax[i] = data.aabb.max[i];
+    }
+    std::memcpy(h.suggested, &data.suggested[0][0], sizeof(h.suggested));
+
+    // 先排布各段偏移
+    std::vector<ModelCacheMesh> table(data.meshes.size());
+    size_t offset = alignUp(sizeof(ModelCacheHeader) + table.size() * sizeof(ModelCacheMesh));
+    for (size_t i = 0; i < data.meshes.size(); ++i) {
+        const MeshData& m = data.meshes[i];
+        table[i].vertexCount = m.vertexCount;
+        table[i].indexCount = m.indexCount;
+        table[i].vertexFormat = (uint32_t)m.format;
+        for (int a = 0; a < 3; ++a) {
+            table[i].dequantOffset[a] = m.dequant.offset[a];
+            table[i].dequantScale[a] = m.dequant.scale[a];
+        }
+        table[i].lodCount = m.lodCount;
+        for (uint32_t l = 0; l < m.lodCount && l < (uint32_t)MAX_MESH_LODS; ++l) {
+            table[i].lodFirstIndex[l] = m.lods[l].firstIndex;
+            table[i].lodIndexCount[l] = m.lods[l].indexCount;
+            table[i].lodError[l] = m.lods[l].error;
+        }
+        table[i].vertexOffset = offset;
+        offset = alignUp(offset + (size_t)m.vertexCount * vertexStride(m.format));
+        table[i].indexOffset = offset;
+        offset = alignUp(offset + (size_t)m.indexCount * sizeof(uint32_t));
+    }
+    if (data.albedo.kind != AlbedoKind::None) {
+        h.albedoOffset = offset;
+        h.albedoSize = data.albedo.size;
+        offset += data.albedo.size;
+    }
+
+    std::vector<unsigned char> buf(offset, 0);
+    std::memcpy(buf.data(), &h, sizeof(h));
+    if (!table.empty()) {
+        std::memcpy(buf.data() + sizeof(h), table.data(), table.size() * sizeof(ModelCacheMesh));
+    }
+    for (size_t i = 0; i < data.meshes.size(); ++i) {
+        const MeshData& m = data.meshes[i];
+        if (m.vertexCount) std::memcpy(buf.data() + table[i].vertexOffset, m.vertices, (size_t)m.vertexCount * vertexStride(m.format));
+        if (m.indexCount) std::memcpy(buf.data() + table[i].indexOffset, m.indices, (size_t)m.indexCount * sizeof(uint32_t));
+    }
+    if (data.albedo.kind != AlbedoKind::None && data.albedo.size) {
+        std::memcpy(buf.data() + h.albedoOffset, data.albedo.bytes, data.albedo.size);
+    }
+
+    const std::string path = cachePath(sourcePath);
+    const std::string tmp = path + ".tmp";
+    std::error_code ec;
+    fs::create_directories(cfg::MODEL_CACHE_DIR, ec);
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f || !f.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size())) {
+            util::logWarn("Failed to write model cache: " + tmp);
+            return false;
+        }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        util::logWarn("Failed to write model cache: " + path + " (" + ec.message() + ")");
+        fs::remove(tmp, ec);
+        return false;
+    }
+    util::logInfo("Wrote model cache: " + path);
+    return true;
+}
+
+} // namespace modelcache
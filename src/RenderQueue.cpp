@@ -0,0 +1,138 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+
+namespace sortkey {
+
+uint32_t quantizeDepth(float depth01) {
+    const uint32_t maxValue = (1u << DEPTH_BITS) - 1u;
+    float d = std::min(1.0f, std::max(0.0f, depth01));
+    return (uint32_t)(d * (float)maxValue + 0.5f);
+}
+
+uint64_t make(RenderPass pass, bool translucent, uint8_t shader, uint32_t texture, float depth01, uint32_t sequence) {
+    const uint64_t depthMask = (1ull << DEPTH_BITS) - 1ull;
+    uint64_t key = (uint64_t)pass << PASS_SHIFT;
+    uint64_t seq = (uint64_t)(sequence & ((1u << SEQUENCE_BITS) - 1u));
+    uint64_t tex = (uint64_t)(texture & 0xFFFFu);
+    uint64_t depth = (uint64_t)quantizeDepth(depth01);
+
+    if (translucent) {
+        // 半透明：深度优先，远处先画
+        key |= 1ull << TRANSLUCENT_SHIFT;
+        key |= ((depthMask - depth) & depthMask) << 36;
+        key |= (uint64_t)shader << 28;
+        key |= tex << 12;
+    } else {
+        // 不透明：状态优先，同状态内近处先画以利用提前深度测试
+        key |= (uint64_t)shader << 52;
+        key |= tex << 36;
+        key |= depth << 12;
+    }
+    return key | seq;
+}
+
+uint64_t makeOrdered(RenderPass pass, uint32_t sequence) {
+    return ((uint64_t)pass << PASS_SHIFT) | (uint64_t)sequence;
+}
+
+} // namespace sortkey
+
+void RenderQueue::clear() {
+    m_commands.clear();
+    m_keys.clear();
+    m_order.clear();
+    m_sequence = 0;
+}
+
+void RenderQueue::submit(RenderPass pass, bool translucent, float depth01, const RenderCommand& cmd) {
+    m_keys.push_back(sortkey::make(pass, translucent, cmd.state.shader, cmd.state.texture, depth01, m_sequence++));
+    m_commands.push_back(cmd);
+}
+
+void RenderQueue::submitOrdered(RenderPass pass, const RenderCommand& cmd) {
+    m_keys.push_back(sortkey::makeOrdered(pass, m_sequence++));
+    m_commands.push_back(cmd);
+}
+
+void RenderQueue::sort() {
+    const size_t n = m_keys.size();
+    m_order.resize(n);
+    m_scratch.resize(n);
+    for (size_t i = 0; i < n; ++i) m_order[i] = (uint32_t)i;
+    if (n < 2) return;
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        uint32_t counts[256] = {};
+        for (size_t i = 0; i < n; ++i) {
+            counts[(m_keys[i] >> shift) & 0xFF]++;
+        }
+        // 所有键在此字节相同：本趟不改变顺序
+        if (counts[(m_keys[0] >> shift) & 0xFF] == n) continue;
+
+        uint32_t offset = 0;
+        for (uint32_t& c : counts) {
+            uint32_t k = c;
+            c = offset;
+            offset += k;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t idx = m_order[i];
+            m_scratch[counts[(m_keys[idx] >> shift) & 0xFF]++] = idx;
+        }
+        m_order.swap(m_scratch);
+    }
+}
+
+RenderQueueStats RenderQueue::execute(RenderExecutor& exec) const {
+    RenderQueueStats stats;
+    if (m_order.size() != m_commands.size()) return stats;
+
+    bool havePass = false;
+    RenderPass pass = RenderPass::Shadow;
+    bool haveState = false;
+    RenderState cur;
+
+    for (uint32_t idx : m_order) {
+        const RenderCommand& cmd = m_commands[idx];
+        const RenderState& s = cmd.state;
+
+        RenderPass p = sortkey::pass(m_keys[idx]);
+        if (!havePass || p != pass) {
+            if (havePass) exec.endPass(pass);
+            exec.beginPass(p);
+            pass = p;
+            havePass = true;
+            haveState = false; // 通道切换后状态由执行器重新建立
+            stats.passChanges++;
+        }
+
+        if (!haveState || s.shader != cur.shader) {
+            exec.setShader(s.shader);
+            stats.shaderChanges++;
+        }
+        if (!haveState || s.texture != cur.texture) {
+            exec.setTexture(s.texture);
+            stats.textureChanges++;
+        }
+        if (!haveState || s.blend != cur.blend) {
+            exec.setBlend(s.blend);
+            stats.blendChanges++;
+        }
+        if (!haveState || s.depthTest != cur.depthTest || s.depthWrite != cur.depthWrite) {
+            exec.setDepth(s.depthTest, s.depthWrite);
+            stats.depthChanges++;
+        }
+        if (!haveState || s.cull != cur.cull) {
+            exec.setCull(s.cull);
+            stats.cullChanges++;
+        }
+        cur = s;
+        haveState = true;
+
+        exec.draw(cmd);
+        stats.commands++;
+    }
+    if (havePass) exec.endPass(pass);
+    return stats;
+}
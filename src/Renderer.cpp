@@ -1,14 +1,36 @@
 #include "Renderer.hpp"
 
 #include "Config.hpp"
+#include "StreamBuffer.hpp"
 #include "Util.hpp"
+#include "Vfs.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
 #include <vector>
 
+// basic.frag 特性宏，下标对应 ShaderFeature 的位
+static const std::vector<std::string> BASIC_FEATURES = {
+    "USE_TEXTURE",
+    "USE_TEXTURE_ALPHA",
+    "USE_NORMAL_MAP",
+    "USE_SHADOW",
+};
+
+// 队列中的着色器编号：高 4 位为 ShaderId，低 4 位为特性掩码，使同一变体在排序后相邻
+static uint8_t shaderKey(ShaderId id, uint32_t features) {
+    return (uint8_t)(((uint32_t)id << 4) | (features & 0xFu));
+}
+
+// 视距归一化范围：排序键中的深度 = 到相机距离 / 该值
+static constexpr float QUEUE_DEPTH_RANGE = 64.0f;
+
 // 根据阵营返回默认棋子颜色
 static glm::vec3 sideColor(Side s) {
     return (s == Side::Red) ? glm::vec3(0.78f, 0.18f, 0.18f) : glm::vec3(0.12f, 0.12f, 0.12f);
@@ -38,28 +60,6 @@ static AABB transformAABB(const AABB& a, const glm::mat4& M) {
     return out;
 }
 
-// 构建界面用单位四边形
-static Mesh makeUiQuad() {
-    std::vector<VertexPN> v;
-    v.reserve(6);
-
-    const glm::vec3 n(0.0f, 0.0f, 1.0f);
-    const glm::vec3 p0(0.0f, 0.0f, 0.0f);
-    const glm::vec3 p1(1.0f, 0.0f, 0.0f);
-    const glm::vec3 p2(1.0f, 1.0f, 0.0f);
-    const glm::vec3 p3(0.0f, 1.0f, 0.0f);
-
-    v.push_back(VertexPN{p0, n, glm::vec2(0.0f, 0.0f)});
-    v.push_back(VertexPN{p1, n, glm::vec2(1.0f, 0.0f)});
-    v.push_back(VertexPN{p2, n, glm::vec2(1.0f, 1.0f)});
-
-    v.push_back(VertexPN{p0, n, glm::vec2(0.0f, 0.0f)});
-    v.push_back(VertexPN{p2, n, glm::vec2(1.0f, 1.0f)});
-    v.push_back(VertexPN{p3, n, glm::vec2(0.0f, 1.0f)});
-
-    return Mesh::fromTrianglesNonIndexed(v);
-}
-
 // 将正弦映射到 0..1
 static float sine01(float t) {
     return 0.5f + 0.5f * std::sin(t);
@@ -84,19 +84,40 @@ bool Renderer::init(int viewportW, int viewportH) {
     m_w = viewportW;
     m_h = viewportH;
 
+    m_basicVariants = ShaderVariants("assets/shaders/basic.vert", "assets/shaders/basic.frag", BASIC_FEATURES);
+    m_pieceVariants = ShaderVariants("assets/shaders/piece.vert", "assets/shaders/basic.frag", BASIC_FEATURES);
+    m_pieceArrayVariants = ShaderVariants("assets/shaders/piece.vert", "assets/shaders/basic.frag", BASIC_FEATURES);
+    applyShadowKernel();
+
     try {
-        m_basicShader = Shader("assets/shaders/basic.vert", "assets/shaders/basic.frag");
         m_lineShader  = Shader("assets/shaders/line.vert",  "assets/shaders/line.frag");
         m_shadowShader = Shader("assets/shaders/shadow.vert", "assets/shaders/shadow.frag");
+
+        // 预编译绘制中会用到的变体，避免首帧卡顿，并让源码错误在初始化时暴露
+        const uint32_t basicMasks[] = {
+            0,
+            FEATURE_TEXTURE,
+            FEATURE_SHADOW,
+            FEATURE_TEXTURE | FEATURE_SHADOW,
+            FEATURE_NORMAL_MAP | FEATURE_SHADOW,
+            FEATURE_TEXTURE | FEATURE_NORMAL_MAP | FEATURE_SHADOW,
+        };
+        for (uint32_t mask : basicMasks) m_basicVariants.get(mask);
+        m_pieceVariants.get(0);
+        m_pieceVariants.get(FEATURE_TEXTURE);
+        if (cfg::PIECE_ALBEDO_ARRAY) m_pieceArrayVariants.get(0);
     } catch (const std::exception& e) {
         util::logError(e.what());
         return false;
     }
+    if (!m_ui.init()) return false;
+    resolveUniforms();
+    initUniformBuffers();
 
     m_fallbackDisc = prim::makeDisc(0.23f, 32);
-    m_uiQuad = makeUiQuad();
 
     ensureLineGrid();
+    glGenBuffers(1, &m_instanceVBO);
 
     m_boardPath = findBoardModelPath();
     if (m_boardPath.empty()) {
@@ -104,47 +125,91 @@ bool Renderer::init(int viewportW, int viewportH) {
         return false;
     }
 
-    if (util::fileExists(cfg::MENU_BG_TEXTURE)) {
-        m_menuBg = Texture2D::fromFile(cfg::MENU_BG_TEXTURE, false);
+    // 界面与法线贴图在后续帧中经 PBO 上传，驻留前按未加载处理
+    unsigned hw = std::thread::hardware_concurrency();
+    if (!m_textures.init(cfg::TEXTURE_STREAM_SLOT_BYTES, cfg::TEXTURE_STREAM_SLOTS, hw > 2 ? 2u : 1u)) {
+        util::logWarn("Texture streaming unavailable, uploading synchronously.");
+    }
+    m_resources.init(&m_textures);
+    if (vfs::exists(cfg::MENU_BG_TEXTURE)) {
+        m_menuBg = m_resources.loadTexture(cfg::MENU_BG_TEXTURE, ResourceCategory::UiTexture, false);
     } else {
         util::logWarn(std::string("Menu background not found: ") + cfg::MENU_BG_TEXTURE);
     }
-    if (util::fileExists(cfg::CHECK_OVERLAY_TEXTURE)) {
-        m_checkOverlay = Texture2D::fromFile(cfg::CHECK_OVERLAY_TEXTURE, false);
+    if (vfs::exists(cfg::CHECK_OVERLAY_TEXTURE)) {
+        m_checkOverlay = m_resources.loadTexture(cfg::CHECK_OVERLAY_TEXTURE, ResourceCategory::UiTexture, false);
     } else {
         util::logWarn(std::string("Check overlay not found: ") + cfg::CHECK_OVERLAY_TEXTURE);
     }
-    if (util::fileExists(cfg::RED_WIN_OVERLAY_TEXTURE)) {
-        m_redWinOverlay = Texture2D::fromFile(cfg::RED_WIN_OVERLAY_TEXTURE, false);
+    if (vfs::exists(cfg::RED_WIN_OVERLAY_TEXTURE)) {
+        m_redWinOverlay = m_resources.loadTexture(cfg::RED_WIN_OVERLAY_TEXTURE, ResourceCategory::UiTexture, false);
     } else {
         util::logWarn(std::string("Red win overlay not found: ") + cfg::RED_WIN_OVERLAY_TEXTURE);
     }
-    if (util::fileExists(cfg::BLACK_WIN_OVERLAY_TEXTURE)) {
-        m_blackWinOverlay = Texture2D::fromFile(cfg::BLACK_WIN_OVERLAY_TEXTURE, false);
+    if (vfs::exists(cfg::BLACK_WIN_OVERLAY_TEXTURE)) {
+        m_blackWinOverlay = m_resources.loadTexture(cfg::BLACK_WIN_OVERLAY_TEXTURE, ResourceCategory::UiTexture, false);
     } else {
         util::logWarn(std::string("Black win overlay not found: ") + cfg::BLACK_WIN_OVERLAY_TEXTURE);
     }
-    if (util::fileExists(cfg::GAME_BG_TEXTURE)) {
-        m_gameBg = Texture2D::fromFile(cfg::GAME_BG_TEXTURE, false);
+    if (vfs::exists(cfg::GAME_BG_TEXTURE)) {
+        m_gameBg = m_resources.loadTexture(cfg::GAME_BG_TEXTURE, ResourceCategory::UiTexture, false);
     } else {
         util::logWarn(std::string("Game background not found: ") + cfg::GAME_BG_TEXTURE);
     }
-    if (util::fileExists(cfg::BOARD_NORMAL_MAP)) {
-        m_boardNormal = Texture2D::fromFile(cfg::BOARD_NORMAL_MAP, true);
+    if (vfs::exists(cfg::BOARD_NORMAL_MAP)) {
+        m_boardNormal = m_resources.loadTexture(cfg::BOARD_NORMAL_MAP, ResourceCategory::ModelTexture, true);
     } else {
         util::logWarn(std::string("Board normal map not found: ") + cfg::BOARD_NORMAL_MAP);
     }
 
+    createShadowMap();
+
+    m_text.setSdf(cfg::TEXT_SDF);
+    bool textOk = m_text.init(cfg::FONT_PATH, viewportW, viewportH);
+    if (!textOk) {
+        const char* fallbacks[] = {
+            "C:/Windows/Fonts/msyh.ttc",
+            "C:/Windows/Fonts/msyh.ttf",
+            "C:/Windows/Fonts/simhei.ttf",
+            "C:/Windows/Fonts/simsun.ttc",
+        };
+        for (const char* path : fallbacks) {
+            if (vfs::exists(path) && m_text.init(path, viewportW, viewportH)) {
+                util::logInfo(std::string("Using fallback font: ") + path);
+                textOk = true;
+                break;
+            }
+        }
+    }
+    if (!textOk) {
+        util::logWarn("TextRenderer init failed (no font found).");
+    }
+
+    return true;
+}
+
+// 创建（或按新分辨率重建）阴影贴图：深度比较模式 + 线性过滤，采样即硬件 PCF
+void Renderer::createShadowMap() {
+    if (m_shadowFBO) glDeleteFramebuffers(1, &m_shadowFBO);
+    if (m_shadowTex) glDeleteTextures(1, &m_shadowTex);
+    m_shadowFBO = 0;
+    m_shadowTex = 0;
+    m_shadowValid = false;
+
     glGenFramebuffers(1, &m_shadowFBO);
     glGenTextures(1, &m_shadowTex);
     glBindTexture(GL_TEXTURE_2D, m_shadowTex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, m_shadowSize, m_shadowSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, m_shadowSize, m_shadowSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
     float borderColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
     glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_resources.setExternalBytes("shadow_map", ResourceCategory::RenderTarget, (size_t)m_shadowSize * m_shadowSize * 4);
 
     glBindFramebuffer(GL_FRAMEBUFFER, m_shadowFBO);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_shadowTex, 0);
@@ -158,28 +223,37 @@ bool Renderer::init(int viewportW, int viewportH) {
         m_shadowTex = 0;
     }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
 
-    bool textOk = m_text.init(cfg::FONT_PATH, viewportW, viewportH);
-    if (!textOk) {
-        const char* fallbacks[] = {
-            "C:/Windows/Fonts/msyh.ttc",
-            "C:/Windows/Fonts/msyh.ttf",
-            "C:/Windows/Fonts/simhei.ttf",
-            "C:/Windows/Fonts/simsun.ttc",
-        };
-        for (const char* path : fallbacks) {
-            if (util::fileExists(path) && m_text.init(path, viewportW, viewportH)) {
-                util::logInfo(std::string("Using fallback font: ") + path);
-                textOk = true;
-                break;
-            }
-        }
-    }
-    if (!textOk) {
-        util::logWarn("TextRenderer init failed (no font found).");
+// 设置阴影质量；已初始化且分辨率变化时重建阴影贴图
+void Renderer::setShadowQuality(int size, ShadowKernel kernel) {
+    size = std::max(256, std::min(size, 8192));
+    bool rebuild = (m_shadowFBO != 0 && size != m_shadowSize);
+    m_shadowSize = size;
+    if (kernel != m_shadowKernel) {
+        m_shadowKernel = kernel;
+        applyShadowKernel();
     }
+    if (rebuild) createShadowMap();
+}
 
-    return true;
+bool parseShadowKernel(const std::string& name, ShadowKernel& out) {
+    if (name == "pcf1")    { out = ShadowKernel::Pcf1;    return true; }
+    if (name == "pcf4")    { out = ShadowKernel::Pcf4;    return true; }
+    if (name == "pcf9")    { out = ShadowKernel::Pcf9;    return true; }
+    if (name == "pcf16")   { out = ShadowKernel::Pcf16;   return true; }
+    if (name == "poisson") { out = ShadowKernel::Poisson; return true; }
+    return false;
+}
+
+ShadowKernel defaultShadowKernel() {
+    ShadowKernel k = ShadowKernel::Pcf9;
+    parseShadowKernel(cfg::SHADOW_KERNEL, k);
+    return k;
+}
+
+void Renderer::shutdown() {
+    m_textures.shutdown();
 }
 
 // 视口大小变化时同步更新
@@ -199,9 +273,9 @@ glm::vec3 Renderer::boardToWorld(const Pos& p) const {
 
 // 寻找棋盘模型路径
 std::string Renderer::findBoardModelPath() const {
-    if (util::fileExists(cfg::BOARD_MODEL_GLB))  return cfg::BOARD_MODEL_GLB;
-    if (util::fileExists(cfg::BOARD_MODEL_GLTF)) return cfg::BOARD_MODEL_GLTF;
-    if (util::fileExists(cfg::BOARD_MODEL_OBJ))  return cfg::BOARD_MODEL_OBJ;
+    if (vfs::exists(cfg::BOARD_MODEL_GLB))  return cfg::BOARD_MODEL_GLB;
+    if (vfs::exists(cfg::BOARD_MODEL_GLTF)) return cfg::BOARD_MODEL_GLTF;
+    if (vfs::exists(cfg::BOARD_MODEL_OBJ))  return cfg::BOARD_MODEL_OBJ;
     return {};
 }
 
@@ -211,9 +285,9 @@ std::string Renderer::findPieceModelPath(const std::string& key) const {
     const std::string glb  = base + ".glb";
     const std::string gltf = base + ".gltf";
     const std::string obj  = base + ".obj";
-    if (util::fileExists(glb))  return glb;
-    if (util::fileExists(gltf)) return gltf;
-    if (util::fileExists(obj))  return obj;
+    if (vfs::exists(glb))  return glb;
+    if (vfs::exists(gltf)) return gltf;
+    if (vfs::exists(obj))  return obj;
     return {};
 }
 
@@ -233,6 +307,7 @@ const Model* Renderer::getPieceModelOrNull(const std::string& key) {
     Model m(path);
     bool ok = m.valid();
     m_pieceModels.emplace(key, std::move(m));
+    m_shadowValid = false;
     return ok ? &m_pieceModels.at(key) : nullptr;
 }
 
@@ -275,13 +350,18 @@ void Renderer::ensureLineGrid() {
     glBindVertexArray(0);
 }
 
-// 开始预加载模型资源
+// 预加载任务中棋盘的键（棋子用 pieceKey）
+static const std::string BOARD_ASSET_KEY = "board";
+
+// 开始预加载模型资源：路径在此解析，读取/导入/解码全部投递给工作线程
 void Renderer::beginPreload() {
     m_preloadFailed = false;
     m_boardLoaded = false;
     m_hasBoardModel = false;
-    m_pendingPieces.clear();
-    m_pendingIndex = 0;
+    m_loadReport = AssetLoadReport{};
+    m_loadReported = false;
+    m_loadStart = std::chrono::steady_clock::now();
+    m_lastPreloadStep = m_loadStart;
 
     static const PieceType types[] = {
         PieceType::King,
@@ -293,50 +373,224 @@ void Renderer::beginPreload() {
         PieceType::Pawn,
     };
 
+    unsigned hw = std::thread::hardware_concurrency();
+    m_assets.start(std::min(4u, std::max(1u, hw > 1 ? hw - 1 : 1u)));
+    m_assets.submit(BOARD_ASSET_KEY, m_boardPath);
+
     Side sides[] = {Side::Red, Side::Black};
     for (Side s : sides) {
         for (PieceType t : types) {
-            m_pendingPieces.push_back(Piece{s, t});
+            std::string key = pieceKey(Piece{s, t});
+            if (m_pieceModels.count(key)) continue;
+            std::string path = findPieceModelPath(key);
+            if (path.empty()) {
+                m_pieceModels.emplace(key, Model());
+                continue;
+            }
+            m_assets.submit(key, path);
         }
     }
 }
 
-// 分步预加载，防止卡顿
-bool Renderer::preloadStep(int maxItems) {
-    int loaded = 0;
-    while (loaded < maxItems) {
-        if (m_preloadFailed) break;
-
-        if (!m_boardLoaded) {
-            m_boardModel = Model(m_boardPath);
-            m_hasBoardModel = m_boardModel.valid();
-            if (!m_hasBoardModel) {
-                util::logError("Board model failed to load.");
-                m_preloadFailed = true;
-                break;
-            }
-            computeBoardModelTransform();
-            m_boardLoaded = true;
-            loaded++;
-            continue;
+// 几何哈希：各网格的内容哈希（工作线程已算好）与建议变换都相同的模型可以互相替代绘制
+static uint64_t geometryHash(const ModelData& data) {
+    uint64_t h = CONTENT_HASH_SEED;
+    for (const auto& m : data.meshes) h = contentHash(&m.hash, sizeof(m.hash), h);
+    return contentHash(&data.suggested, sizeof(data.suggested), h);
+}
+
+// 在 GL 线程上创建一个已就绪模型的 GPU 资源
+void Renderer::acceptLoadedModel(LoadedModel& item) {
+    const Model* model = nullptr;
+    if (item.key == BOARD_ASSET_KEY) {
+        if (item.ok) m_boardModel = Model(item.data, &m_resources);
+        m_hasBoardModel = m_boardModel.valid();
+        if (!m_hasBoardModel) {
+            util::logError("Board model failed to load.");
+            m_preloadFailed = true;
+            return;
         }
+        // 棋子的反照率由 buildPieceMaterials 汇报，这里只报告棋盘
+        if (m_boardModel.albedoId() != 0) { // 可能仍在流式上传，按纹理名判断
+            util::logInfo("Loaded board albedo texture from model material.");
+        } else {
+            util::logWarn("No albedo/diffuse texture found in model material (board will render with solid color).");
+        }
+        computeBoardModelTransform();
+        m_boardLoaded = true;
+        model = &m_boardModel;
+    } else {
+        // 反照率留给纹理数组：像素拷出后模型按无纹理创建，全部棋子就绪后统一装箱
+        const AlbedoData& albedo = item.data.albedo;
+        if (cfg::PIECE_ALBEDO_ARRAY && item.ok && albedo.kind == AlbedoKind::Rgba) {
+            m_albedoPacker.add(item.key, std::vector<unsigned char>(albedo.bytes, albedo.bytes + albedo.size),
+                               albedo.width, albedo.height, albedo.hash);
+            item.data.albedo = AlbedoData{};
+        }
+        if (item.ok) m_pieceGeometry[item.key] = geometryHash(item.data);
+        Model m = item.ok ? Model(item.data, &m_resources) : Model();
+        model = &m_pieceModels.insert_or_assign(item.key, std::move(m)).first->second;
+    }
+    m_shadowValid = false;
+
+    // 顶点显存：实际字节数与全部使用 VertexPN 时的字节数
+    const size_t gpuBytes = model->vertexBytes();
+    const size_t fullBytes = model->vertexCount() * sizeof(VertexPN);
+    m_loadReport.vertexBytes += gpuBytes;
+    m_loadReport.vertexBytesFull += fullBytes;
+
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), " (worker %.1f ms, vertex %.1f KB / %.1f KB unpacked)",
+        item.workMs, (double)gpuBytes / 1024.0, (double)fullBytes / 1024.0);
+    util::logInfo("Loaded model: " + item.path + buf);
+}
 
-        if (m_pendingIndex < m_pendingPieces.size()) {
-            Piece p = m_pendingPieces[m_pendingIndex++];
-            (void)getPieceModelOrNull(pieceKey(p));
-            loaded++;
+// 每帧调用：上传已就绪的模型，直到用完本帧预算（至少上传一个，保证前进）
+bool Renderer::preloadStep(double budgetMs) {
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    if (m_preloadFailed || m_loadReported) return isPreloadReady();
+
+    auto t0 = Clock::now();
+    double frameMs = ms(t0 - m_lastPreloadStep);
+    m_lastPreloadStep = t0;
+    m_loadReport.frames++;
+    m_loadReport.maxFrameMs = std::max(m_loadReport.maxFrameMs, frameMs);
+    if (frameMs > cfg::ASSET_HITCH_MS) m_loadReport.hitches++;
+
+    while (!m_preloadFailed) {
+        std::unique_ptr<LoadedModel> item = m_assets.poll();
+        if (!item) break;
+        acceptLoadedModel(*item);
+        m_loadReport.models++;
+        m_loadReport.workMs += item->workMs;
+        if (ms(Clock::now() - t0) >= budgetMs) break;
+    }
+
+    double sliceMs = ms(Clock::now() - t0);
+    m_loadReport.uploadMs += sliceMs;
+    m_loadReport.maxSliceMs = std::max(m_loadReport.maxSliceMs, sliceMs);
+
+    if (m_preloadFailed || m_assets.outstanding() == 0) {
+        m_assets.stop();
+        m_loadReported = true;
+        m_loadReport.wallMs = ms(Clock::now() - m_loadStart);
+
+        const AssetLoadReport& r = m_loadReport;
+        char buf[320];
+        std::snprintf(buf, sizeof(buf),
+            "Assets loaded: models=%u wall=%.1fms worker=%.1fms upload=%.1fms max_slice=%.2fms "
+            "frames=%u max_frame=%.1fms hitches=%u (>%.1fms) vertex_kb=%.1f (unpacked %.1f)",
+            r.models, r.wallMs, r.workMs, r.uploadMs, r.maxSliceMs, r.frames, r.maxFrameMs, r.hitches,
+            cfg::ASSET_HITCH_MS, (double)r.vertexBytes / 1024.0, (double)r.vertexBytesFull / 1024.0);
+        util::logInfo(buf);
+
+        if (!m_preloadFailed) buildPieceMaterials();
+    }
+    return isPreloadReady();
+}
+
+// 全部棋子就绪后：反照率装入纹理数组（各层在之后的帧中上传），装不下的交回各自模型单独绑定；
+// 其余棋子按几何哈希分组，组内键序最小者作为代表绘制全组实例
+void Renderer::buildPieceMaterials() {
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    const int layers = m_albedoPacker.pack(maxLayers);
+
+    std::unordered_map<std::string, int> layerOf;
+    size_t separate = 0;
+    for (auto& img : m_albedoPacker.images()) {
+        if (img.layer >= 0) {
+            layerOf[img.key] = img.layer;
             continue;
         }
+        auto it = m_pieceModels.find(img.key);
+        if (it == m_pieceModels.end()) continue;
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "Piece albedo %s is %dx%d, array layers are %dx%d: bound separately.",
+            img.key.c_str(), img.width, img.height, m_albedoPacker.layerWidth(), m_albedoPacker.layerHeight());
+        util::logWarn(buf);
+        it->second.setAlbedo(m_resources.acquireTexture(img.hash, ResourceCategory::ModelTexture, true, [&] {
+            return Texture2D::fromPixelsAsync(m_textures, std::move(img.rgba), img.width, img.height, true);
+        }));
+        m_pieceGeometry.erase(img.key); // 单独绑定纹理的棋子不参与合并
+        separate++;
+    }
 
-        break;
+    // 按键排序，代表的选择与工作线程完成的先后无关
+    std::vector<std::string> keys;
+    keys.reserve(m_pieceGeometry.size());
+    for (const auto& entry : m_pieceGeometry) keys.push_back(entry.first);
+    std::sort(keys.begin(), keys.end());
+
+    std::unordered_map<uint64_t, const Model*> representative;
+    for (const auto& key : keys) {
+        const Model* model = &m_pieceModels.at(key);
+        if (!model->valid()) continue;
+        const Model* drawModel = representative.emplace(m_pieceGeometry.at(key), model).first->second;
+        auto layer = layerOf.find(key);
+        m_pieceMaterials[model] = PieceMaterial{drawModel, layer != layerOf.end() ? layer->second : -1};
+    }
+    m_pieceGeometry.clear();
+
+    if (layers > 0) {
+        m_pieceAlbedos = Texture2DArray::create(m_albedoPacker.layerWidth(), m_albedoPacker.layerHeight(), layers, true);
+        const size_t bytes = (size_t)m_pieceAlbedos.width() * m_pieceAlbedos.height() * 4 * layers;
+        m_resources.setExternalBytes("piece_albedo_array", ResourceCategory::TextureArray, bytes + bytes / 3);
+        m_albedoUploadNext = 0;
+        m_pieceAlbedosReady = false;
+    }
+    if (!m_pieceAlbedos.valid()) m_albedoPacker.clear();
+
+    char buf[224];
+    std::snprintf(buf, sizeof(buf), "Piece materials: %d albedo layers (%dx%d), %d duplicate albedos, %zu bound separately, "
+        "%zu draw models for %zu pieces",
+        layers, m_albedoPacker.layerWidth(), m_albedoPacker.layerHeight(), m_albedoPacker.duplicateCount(), separate,
+        representative.size(), keys.size());
+    util::logInfo(buf);
+}
+
+// 在字节预算内逐层上传纹理数组（每帧至少一层，保证前进）；全部上传后生成 mip 并启用
+void Renderer::uploadPieceAlbedos(size_t budgetBytes) {
+    m_albedoUploadBytes = 0;
+    if (m_albedoPacker.empty() || !m_pieceAlbedos.valid()) return;
+
+    auto& images = m_albedoPacker.images();
+    const size_t layerBytes = (size_t)m_pieceAlbedos.width() * (size_t)m_pieceAlbedos.height() * 4;
+    size_t sent = 0;
+    for (; m_albedoUploadNext < images.size(); ++m_albedoUploadNext) {
+        const auto& img = images[m_albedoUploadNext];
+        if (img.layer < 0 || img.source >= 0) continue;
+        if (sent > 0 && sent + layerBytes > budgetBytes) break;
+        m_pieceAlbedos.uploadLayer(img.layer, img.rgba.data());
+        sent += layerBytes;
     }
+    m_albedoUploadBytes = (uint32_t)sent;
+    if (m_albedoUploadNext < images.size()) return;
 
-    return isPreloadReady();
+    m_pieceAlbedos.generateMips();
+    m_albedoPacker.clear();
+    m_pieceAlbedosReady = true;
 }
 
-// 预加载是否完成
+// 预加载是否完成（模型已上传且纹理均已驻留）
 bool Renderer::isPreloadReady() const {
-    return !m_preloadFailed && m_boardLoaded && m_pendingIndex >= m_pendingPieces.size();
+    return !m_preloadFailed && m_boardLoaded && m_assets.outstanding() == 0 && m_textures.pending() == 0 &&
+           m_albedoPacker.empty();
+}
+
+// 纹理数组的层与流式纹理共用每帧字节预算
+void Renderer::streamTextures() {
+    m_textures.update(cfg::TEXTURE_UPLOAD_BUDGET_BYTES);
+    const size_t used = m_textures.stats().uploadBytes;
+    uploadPieceAlbedos(cfg::TEXTURE_UPLOAD_BUDGET_BYTES > used ? cfg::TEXTURE_UPLOAD_BUDGET_BYTES - used : 0);
+
+    // 全部资源驻留后输出一次显存分布
+    if (!m_resourcesReported && isPreloadReady()) {
+        m_resources.logStats();
+        m_resourcesReported = true;
+    }
 }
 
 // 计算棋盘模型的自适应变换
@@ -378,403 +632,745 @@ void Renderer::computeBoardModelTransform() {
     util::logInfo("Board model auto-fit applied (rotation+scale+top-align).");
 }
 
-// 主渲染入口
-void Renderer::draw(const OrbitCamera& cam, const XiangqiGame& game) {
-    if (!m_boardLoaded) {
-        glViewport(0, 0, m_w, m_h);
-        glClearColor(0.08f, 0.08f, 0.10f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        return;
+// 解析 basic.frag 系列程序的变量句柄（实例化程序没有 model/baseColor/alpha，未启用特性的采样器也会被优化掉，对应句柄为空）
+static void resolveBasicUniforms(const Shader& s, BasicShaderUniforms& b) {
+    b.model = s.uniform<glm::mat4>("model");
+    b.baseColor = s.uniform<glm::vec3>("baseColor");
+    b.alpha = s.uniform<float>("alpha");
+    b.albedoMap = s.uniform<int>("albedoMap");
+    b.normalMap = s.uniform<int>("normalMap");
+    b.shadowMap = s.uniform<int>("shadowMap");
+    b.albedoArray = s.uniform<int>("albedoArray");
+}
+
+// 解析各着色器的变量句柄（着色器链接后调用一次）
+void Renderer::resolveUniforms() {
+    m_lineU.model = m_lineShader.uniform<glm::mat4>("model");
+    m_lineU.color = m_lineShader.uniform<glm::vec3>("color");
+}
+
+// 把当前滤波核作为公共宏写入变体；核变化会清空已编译的变体
+void Renderer::applyShadowKernel() {
+    std::vector<std::string> defines = {"SHADOW_KERNEL " + std::to_string((int)m_shadowKernel)};
+    m_basicVariants.setCommonDefines(defines);
+    m_pieceVariants.setCommonDefines(defines);
+    defines.push_back("USE_TEXTURE_ARRAY");
+    m_pieceArrayVariants.setCommonDefines(defines);
+    m_basicResolved = 0;
+    m_pieceResolved = 0;
+    m_pieceArrayResolved = 0;
+}
+
+// 绑定变体程序并返回其句柄；首次使用某掩码时编译并解析
+const BasicShaderUniforms* Renderer::useVariant(ShaderId id, uint32_t features) {
+    ShaderVariants* family = &m_basicVariants;
+    auto* familyHandles = &m_basicVariantU;
+    uint32_t* familyResolved = &m_basicResolved;
+    if (id == ShaderId::Piece) {
+        family = &m_pieceVariants;
+        familyHandles = &m_pieceVariantU;
+        familyResolved = &m_pieceResolved;
+    } else if (id == ShaderId::PieceArray) {
+        family = &m_pieceArrayVariants;
+        familyHandles = &m_pieceArrayVariantU;
+        familyResolved = &m_pieceArrayResolved;
     }
+    ShaderVariants& variants = *family;
+    auto& handles = *familyHandles;
+    uint32_t& resolved = *familyResolved;
+    features &= SHADER_VARIANT_COUNT - 1;
+    if (variants.failed(features)) features = 0; // 已报告过的失败掩码直接回退，不再重编译
 
-    glViewport(0, 0, m_w, m_h);
-    glEnable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
-    glFrontFace(GL_CCW);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    const Shader* program = nullptr;
+    try {
+        program = &variants.get(features);
+    } catch (const std::exception& e) {
+        util::logError(e.what());
+        features = 0;
+        program = &variants.get(0);
+    }
+    if (!(resolved & (1u << features))) {
+        resolveBasicUniforms(*program, handles[features]);
+        resolved |= 1u << features;
+    }
 
-    glClearColor(0.12f, 0.12f, 0.14f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    const BasicShaderUniforms& u = handles[features];
+    program->use();
+    u.albedoMap.set(0);
+    u.shadowMap.set(1);
+    u.normalMap.set(2);
+    u.albedoArray.set(3);
+    return &u;
+}
 
-    if (m_gameBg.valid()) {
-        glDisable(GL_DEPTH_TEST);
-        glm::mat4 Vbg = glm::mat4(1.0f);
-        glm::mat4 Pbg = glm::ortho(0.0f, (float)m_w, 0.0f, (float)m_h);
-
-        m_basicShader.use();
-        m_basicShader.setMat4("view", Vbg);
-        m_basicShader.setMat4("projection", Pbg);
-        m_basicShader.setVec3("lightDir", glm::vec3(0.0f, 0.0f, -1.0f));
-        m_basicShader.setVec3("viewPos", glm::vec3(0.0f, 0.0f, 1.0f));
-        m_basicShader.setFloat("roughness", 1.0f);
-        m_basicShader.setFloat("metalness", 0.0f);
-        m_basicShader.setInt("useShadow", 0);
-        m_basicShader.setInt("useNormalMap", 0);
-        m_basicShader.setInt("useTextureAlpha", 0);
-        m_basicShader.setInt("albedoMap", 0);
-        m_basicShader.setInt("useTexture", 1);
-        m_basicShader.setVec3("baseColor", glm::vec3(1.0f));
-        m_basicShader.setFloat("alpha", 0.54f);
+// 创建帧常量与材质缓冲；材质预设在运行期不变，只写一次
+void Renderer::initUniformBuffers() {
+    m_uiFrameOffset = UniformBuffer::alignOffset(sizeof(FrameUniforms));
+    m_frameStaging.assign(m_uiFrameOffset + sizeof(FrameUniforms), 0);
+    m_frameUbo = UniformBuffer::create(m_frameStaging.size(), nullptr, GL_STREAM_DRAW);
+
+    m_materialStride = UniformBuffer::alignOffset(sizeof(MaterialUniforms));
+    std::vector<unsigned char> data(m_materialStride * (size_t)MaterialPreset::Count, 0);
+    auto put = [&](MaterialPreset p, float roughness, float metalness) {
+        MaterialUniforms m;
+        m.roughness = roughness;
+        m.metalness = metalness;
+        std::memcpy(data.data() + m_materialStride * (size_t)p, &m, sizeof(m));
+    };
+    put(MaterialPreset::Board, cfg::BOARD_ROUGHNESS, cfg::BOARD_METALNESS);
+    put(MaterialPreset::Piece, cfg::PIECE_ROUGHNESS, cfg::PIECE_METALNESS);
+    put(MaterialPreset::Flat, 1.0f, 0.0f);
+    m_materialUbo = UniformBuffer::create(data.size(), data.data(), GL_STATIC_DRAW);
+}
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_gameBg.id());
+// 上传本帧的场景与界面帧常量（一次孤立 + 一次写入）
+void Renderer::uploadFrameUniforms(const FrameUniforms& scene) {
+    FrameUniforms ui;
+    ui.projection = glm::ortho(0.0f, (float)m_w, 0.0f, (float)m_h);
+    ui.time = scene.time;
 
-        glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f));
-        M = glm::scale(M, glm::vec3((float)m_w, (float)m_h, 1.0f));
-        m_basicShader.setMat4("model", M);
-        m_uiQuad.draw();
+    std::memcpy(m_frameStaging.data(), &scene, sizeof(scene));
+    std::memcpy(m_frameStaging.data() + m_uiFrameOffset, &ui, sizeof(ui));
+    m_frameUbo.update(m_frameStaging.data(), m_frameStaging.size());
+}
+
+void Renderer::bindSceneFrame() {
+    m_frameUbo.bindRange(UBO_BINDING_FRAME, 0, sizeof(FrameUniforms));
+}
 
-        glBindTexture(GL_TEXTURE_2D, 0);
-        m_basicShader.setInt("useTexture", 0);
-        m_basicShader.setFloat("alpha", 1.0f);
+void Renderer::bindMaterial(MaterialPreset preset) {
+    m_materialUbo.bindRange(UBO_BINDING_MATERIAL, m_materialStride * (size_t)preset, sizeof(MaterialUniforms));
+}
+
+// 按投影误差选择 LOD：取误差投影到屏幕上不超过 cfg::LOD_MAX_SCREEN_ERROR_PX 的最粗一级。
+// scale 为实例矩阵的缩放（放大/选中动画计入误差），distance 为到包围盒近端的距离
+int Renderer::selectLod(const Model* model, float scale, float distance, float pixelsPerUnit) const {
+    const int n = model->lodCount();
+    if (n <= 1 || pixelsPerUnit <= 0.0f) return 0;
+    for (int lod = n - 1; lod > 0; --lod) {
+        if (model->lodError(lod) * scale / distance * pixelsPerUnit <= cfg::LOD_MAX_SCREEN_ERROR_PX) return lod;
     }
+    return 0;
+}
 
-    glEnable(GL_DEPTH_TEST);
+// 对一个实例做剔除并选择 LOD：主通道按相机视锥与投影大小，阴影通道按光源视锥（只对投射阴影的实例）
+Renderer::PieceItem Renderer::makePieceItem(const Model* model, const InstanceData& inst, bool castsShadow,
+                                            const PieceView& view) {
+    PieceItem item{model, inst, 0, 0};
+    const BoxBounds box = transformBounds(model->aabb(), inst.model);
+    const float radius = glm::length(box.extent);
+    const float distance = std::max(glm::length(box.center - view.eye) - radius, 1e-3f);
+
+    if (!view.camera.intersects(box)) {
+        m_stats.culledFrustum++;
+    } else if (2.0f * radius / distance * view.pixelsPerUnit < cfg::CULL_MIN_SCREEN_PX) {
+        m_stats.culledSmall++;
+    } else {
+        item.visible |= PIECE_VISIBLE_MAIN;
+    }
+    if (castsShadow) {
+        if (view.light.intersects(box)) item.visible |= PIECE_VISIBLE_SHADOW;
+        else m_stats.shadowCulled++;
+    }
+    item.lod = selectLod(model, glm::length(glm::vec3(inst.model[0])), distance, view.pixelsPerUnit);
+    return item;
+}
 
-    glm::mat4 V = cam.view();
-    glm::mat4 P = cam.projection((float)m_w / (float)m_h);
-    glm::vec3 lightDir = glm::normalize(glm::vec3(-1.0f, -1.5f, -0.8f));
-    glm::mat4 lightSpace = makeLightSpaceMatrix(lightDir);
+// 收集本帧全部棋子实例，剔除后按模型与 LOD 分组
+void Renderer::gatherPieceInstances(const XiangqiGame& game, const PieceView& view) {
+    m_instances.clear();
+    m_opaqueBatches.clear();
+    m_shadowBatches.clear();
+    m_glowBatches.clear();
+    m_captureBatches.clear();
 
     const auto& b = game.board();
     const auto& moves = game.moves();
     float timeSec = game.timeSeconds();
 
-    auto isMoveTarget = [&](const Pos& pos) -> bool {
-        for (const auto& mv : moves) {
-            if (mv.to == pos) return true;
+    auto pieceMatrix = [&](const Model* model, const glm::vec3& wpos, float scale) {
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), wpos);
+        M = glm::scale(M, glm::vec3(cfg::PIECE_MODEL_SCALE * scale));
+        return M * model->suggestedTransform();
+    };
+    // 实例的绘制方式：在材质表中的棋子由代表模型绘制、按层号取反照率，其余按自身反照率绘制
+    struct PieceDraw {
+        const Model* model = nullptr;
+        float layer = -1.0f;
+        bool layered = false;
+    };
+    auto pieceDraw = [&](const Model* model) {
+        PieceDraw d{model, -1.0f, false};
+        auto it = m_pieceMaterials.find(model);
+        if (it != m_pieceMaterials.end()) {
+            d.model = it->second.drawModel;
+            d.layer = m_pieceAlbedosReady ? (float)it->second.layer : -1.0f;
+            d.layered = true;
         }
-        return false;
+        return d;
+    };
+    auto pieceColor = [&](const Model* model, const PieceDraw& d, Side side, float alpha) {
+        glm::vec3 c = (d.layered ? d.layer >= 0.0f : model->hasAlbedo()) ? glm::vec3(1.0f) : sideColor(side);
+        return glm::vec4(c, alpha);
+    };
+    auto makeItem = [&](const Model* model, Side side, const glm::mat4& M, float alpha, bool castsShadow) {
+        const PieceDraw d = pieceDraw(model);
+        PieceItem item = makePieceItem(d.model, InstanceData{M, pieceColor(model, d, side, alpha), d.layer}, castsShadow, view);
+        item.layered = d.layered;
+        return item;
     };
 
-    auto moveWorldPos = [&](const MoveVisual& mv) -> glm::vec3 {
+    // 不透明棋子：移动动画中的棋子 + 棋盘上其余棋子
+    m_pieceItems.clear();
+    for (const auto& mv : moves) {
+        const Model* model = getPieceModelOrNull(pieceKey(mv.piece));
+        if (!model) continue;
         float u = (mv.duration > 0.0f) ? std::min(1.0f, mv.t / mv.duration) : 1.0f;
         float k = easeInOut(u);
-        glm::vec3 a = boardToWorld(mv.from);
-        glm::vec3 bpos = boardToWorld(mv.to);
-        glm::vec3 p = glm::mix(a, bpos, k);
-        p.y += cfg::MOVE_LIFT_HEIGHT * std::sin(u * 3.14159265f);
-        return p;
-    };
-
-    bool shadowReady = (m_shadowFBO != 0 && m_shadowTex != 0);
-    if (shadowReady) {
-        glViewport(0, 0, m_shadowSize, m_shadowSize);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_shadowFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
+        glm::vec3 wpos = glm::mix(boardToWorld(mv.from), boardToWorld(mv.to), k);
+        wpos.y += cfg::MOVE_LIFT_HEIGHT * std::sin(u * 3.14159265f);
+        m_pieceItems.push_back(makeItem(model, mv.piece.side, pieceMatrix(model, wpos, 1.0f), 1.0f, true));
+    }
 
-        m_shadowShader.use();
-        m_shadowShader.setMat4("lightSpaceMatrix", lightSpace);
-
-        auto drawShadowModel = [&](const Model* model, const glm::vec3& wpos, float scale) {
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), wpos);
-            M = glm::scale(M, glm::vec3(cfg::PIECE_MODEL_SCALE * scale));
-            M = M * model->suggestedTransform();
-            m_shadowShader.setMat4("model", M);
-            model->draw();
-        };
+    const Model* glowModel = nullptr;
+    glm::mat4 glowM(1.0f);
+    int glowLod = 0;
+    for (int y = 0; y < 10; ++y) {
+        for (int x = 0; x < 9; ++x) {
+            if (!b.cells[y][x]) continue;
+            Pos pos{x, y};
+            bool moving = false;
+            for (const auto& mv : moves) {
+                if (mv.to == pos) { moving = true; break; }
+            }
+            if (moving) continue;
 
-        for (const auto& mv : moves) {
-            const Model* model = getPieceModelOrNull(pieceKey(mv.piece));
+            Piece p = *b.cells[y][x];
+            const Model* model = getPieceModelOrNull(pieceKey(p));
             if (!model) continue;
-            drawShadowModel(model, moveWorldPos(mv), 1.0f);
-        }
-
-        for (int y = 0; y < 10; ++y) {
-            for (int x = 0; x < 9; ++x) {
-                if (!b.cells[y][x]) continue;
-                Pos pos{x, y};
-                if (isMoveTarget(pos)) continue;
 
-                Piece p = *b.cells[y][x];
-                bool selected = game.selected() && *game.selected() == pos;
-                float pulse = selected ? sine01(timeSec * 3.4f) : 0.0f;
-                float scale = selected ? (1.04f + 0.04f * pulse) : 1.0f;
-                float lift = selected ? (0.06f * pulse) : 0.0f;
-
-                glm::vec3 wpos = boardToWorld(pos);
-                wpos.y += lift;
+            bool selected = game.selected() && *game.selected() == pos;
+            float pulse = selected ? sine01(timeSec * 3.4f) : 0.0f;
+            float scale = selected ? (1.04f + 0.04f * pulse) : 1.0f;
+            glm::vec3 wpos = boardToWorld(pos);
+            wpos.y += selected ? (0.06f * pulse) : 0.0f;
 
-                const Model* model = getPieceModelOrNull(pieceKey(p));
-                if (!model) continue;
-                drawShadowModel(model, wpos, scale);
+            PieceItem item = makeItem(model, p.side, pieceMatrix(model, wpos, scale), 1.0f, true);
+            if (selected) {
+                glowModel = item.model;
+                glowM = pieceMatrix(model, wpos, scale * 1.08f);
+                glowLod = item.lod;
             }
+            m_pieceItems.push_back(item);
         }
-
-        glCullFace(GL_BACK);
-        glDisable(GL_CULL_FACE);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(0, 0, m_w, m_h);
     }
+    appendBatches(m_opaqueBatches, &m_shadowBatches);
 
-    m_basicShader.use();
-    m_basicShader.setMat4("view", V);
-    m_basicShader.setMat4("projection", P);
-    m_basicShader.setVec3("lightDir", lightDir);
-    m_basicShader.setVec3("viewPos", cam.position());
-    m_basicShader.setMat4("lightSpaceMatrix", lightSpace);
-    m_basicShader.setInt("shadowMap", 1);
-    m_basicShader.setInt("normalMap", 2);
-    m_basicShader.setFloat("roughness", cfg::BOARD_ROUGHNESS);
-    m_basicShader.setFloat("metalness", cfg::BOARD_METALNESS);
-    m_basicShader.setInt("useShadow", shadowReady ? 1 : 0);
-    m_basicShader.setInt("useNormalMap", m_boardNormal.valid() ? 1 : 0);
-    m_basicShader.setInt("useTextureAlpha", 0);
-
-    m_basicShader.setInt("albedoMap", 0);
-    if (shadowReady) {
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, m_shadowTex);
-    }
-    if (m_boardNormal.valid()) {
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, m_boardNormal.id());
+    m_pieceItems.clear();
+    if (glowModel) {
+        PieceItem glow = makePieceItem(glowModel, InstanceData{glowM, glm::vec4(1.0f, 0.86f, 0.55f, 0.35f)}, false, view);
+        glow.lod = glowLod; // 外壳与本体同级，轮廓才贴合
+        m_pieceItems.push_back(glow);
     }
+    appendBatches(m_glowBatches);
 
-    if (cfg::BOARD_USE_ALBEDO && m_boardModel.hasAlbedo()) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_boardModel.albedoId());
-        m_basicShader.setInt("useTexture", 1);
-        m_basicShader.setVec3("baseColor", glm::vec3(1.0f));
-    } else {
-        m_basicShader.setInt("useTexture", 0);
-        m_basicShader.setVec3("baseColor", glm::vec3(0.62f, 0.47f, 0.28f));
+    m_pieceItems.clear();
+    for (const auto& c : game.captures()) {
+        const Model* model = getPieceModelOrNull(pieceKey(c.piece));
+        if (!model) continue;
+        float k = (c.duration > 0.0f) ? std::min(1.0f, c.t / c.duration) : 1.0f;
+        glm::vec3 wpos = boardToWorld(c.pos);
+        wpos.y -= 0.15f * k;
+        m_pieceItems.push_back(makeItem(model, c.piece.side, pieceMatrix(model, wpos, 1.0f - 0.7f * k), 1.0f - k, false));
     }
+    appendBatches(m_captureBatches);
+}
 
-    m_basicShader.setFloat("alpha", 1.0f);
-    m_basicShader.setMat4("model", m_boardModelXform);
-    m_boardModel.draw();
+// 计算阴影缓存键（与 gatherPieceInstances 中选中棋子的动画保持一致）
+ShadowCacheKey Renderer::makeShadowKey(const XiangqiGame& game) const {
+    ShadowCacheKey key;
+    uint64_t h = 1469598103934665603ull; // FNV-1a
+    const auto& b = game.board();
+    for (int y = 0; y < 10; ++y) {
+        for (int x = 0; x < 9; ++x) {
+            uint8_t v = 0;
+            if (b.cells[y][x]) {
+                const Piece& p = *b.cells[y][x];
+                v = (uint8_t)(1 + (uint8_t)p.side * 8 + (uint8_t)p.type);
+            }
+            h = (h ^ v) * 1099511628211ull;
+        }
+    }
+    key.boardHash = h;
+    key.animating = !game.moves().empty() || !game.captures().empty();
+    if (game.selected()) {
+        key.selected = game.selected()->y * 9 + game.selected()->x;
+        key.pulse = sine01(game.timeSeconds() * 3.4f);
+    }
+    return key;
+}
 
-    glBindTexture(GL_TEXTURE_2D, 0);
-    if (m_boardNormal.valid()) {
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, 0);
+// 统计阴影重画频率：按模拟时间每满一秒发布一次
+void Renderer::countShadowPass(float timeSec, bool rendered) {
+    if (timeSec < m_shadowWindowStart) {
+        m_shadowWindowStart = timeSec; // 对局重开，时间回到 0
+        m_shadowWindowPasses = 0;
     }
-    if (shadowReady) {
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, 0);
+    if (rendered) m_shadowWindowPasses++;
+    float elapsed = timeSec - m_shadowWindowStart;
+    if (elapsed >= 1.0f) {
+        m_shadowPassesPerSec = (uint32_t)((float)m_shadowWindowPasses / elapsed + 0.5f);
+        m_shadowWindowStart = timeSec;
+        m_shadowWindowPasses = 0;
     }
-    glActiveTexture(GL_TEXTURE0);
-    m_basicShader.setInt("useNormalMap", 0);
-    m_basicShader.setInt("useShadow", 0);
+    m_stats.shadowPasses = rendered ? 1u : 0u;
+    m_stats.shadowPassesPerSec = m_shadowPassesPerSec;
+}
 
-    if (cfg::BOARD_DRAW_GRID) {
-        m_lineShader.use();
-        m_lineShader.setMat4("view", V);
-        m_lineShader.setMat4("projection", P);
-        m_lineShader.setMat4("model", glm::mat4(1.0f));
-        m_lineShader.setVec3("color", glm::vec3(0.15f, 0.10f, 0.06f));
-        glBindVertexArray(m_lineVAO);
-        glDrawArrays(GL_LINES, 0, m_lineVertexCount);
-        glBindVertexArray(0);
+// 将 m_pieceItems 按 (模型, LOD) 分组追加到实例数组，每组生成一个批次；两个通道都不可见的实例丢弃。
+// 给出 shadowOut 时同时生成阴影批次：组内按 仅主通道 / 两者 / 仅阴影 排列，两种批次各是组内连续的一段，
+// 阴影批次取再粗一级的 LOD（已是最粗则不变），同模型同级且相邻时合并
+void Renderer::appendBatches(std::vector<InstanceBatch>& out, std::vector<InstanceBatch>* shadowOut) {
+    auto visOrder = [](uint8_t v) { return v == PIECE_VISIBLE_MAIN ? 0 : (v == PIECE_VISIBLE_SHADOW ? 2 : 1); };
+    std::stable_sort(m_pieceItems.begin(), m_pieceItems.end(), [&](const PieceItem& a, const PieceItem& b) {
+        if (a.model != b.model) return std::less<const Model*>()(a.model, b.model);
+        if (a.lod != b.lod) return a.lod < b.lod;
+        return visOrder(a.visible) < visOrder(b.visible);
+    });
+
+    const size_t begin = out.size();
+    for (const auto& item : m_pieceItems) {
+        const uint8_t mask = shadowOut ? (PIECE_VISIBLE_MAIN | PIECE_VISIBLE_SHADOW) : PIECE_VISIBLE_MAIN;
+        if ((item.visible & mask) == 0) continue;
+
+        if (item.visible & PIECE_VISIBLE_MAIN) {
+            if (out.size() == begin || out.back().model != item.model || out.back().lod != item.lod ||
+                out.back().layered != item.layered || out.back().first + (size_t)out.back().count != m_instances.size()) {
+                out.push_back(InstanceBatch{item.model, m_instances.size(), 0, item.lod, item.layered});
+            }
+            out.back().count++;
+        }
+        if (shadowOut && (item.visible & PIECE_VISIBLE_SHADOW)) {
+            const int lod = std::min(item.lod + 1, item.model->lodCount() - 1);
+            InstanceBatch* shadow = shadowOut->empty() ? nullptr : &shadowOut->back();
+            if (!shadow || shadow->model != item.model || shadow->lod != lod ||
+                shadow->first + (size_t)shadow->count != m_instances.size()) {
+                shadowOut->push_back(InstanceBatch{item.model, m_instances.size(), 0, lod});
+                shadow = &shadowOut->back();
+            }
+            shadow->count++;
+        }
+        m_instances.push_back(item.inst);
     }
+}
 
-    m_basicShader.use();
-    m_basicShader.setMat4("view", V);
-    m_basicShader.setMat4("projection", P);
-    m_basicShader.setVec3("lightDir", lightDir);
-    m_basicShader.setVec3("viewPos", cam.position());
-    m_basicShader.setFloat("roughness", 1.0f);
-    m_basicShader.setFloat("metalness", 0.0f);
-    m_basicShader.setInt("useShadow", 0);
-    m_basicShader.setInt("useNormalMap", 0);
-    m_basicShader.setInt("useTexture", 0);
-    m_basicShader.setInt("useTextureAlpha", 0);
+// 上传本帧的实例数据
+void Renderer::uploadInstances() {
+    if (!m_instanceVBO || m_instances.empty()) return;
+    uploadStreamBuffer(m_instanceVBO, m_instanceCapacity, m_instances.data(), m_instances.size() * sizeof(InstanceData));
+}
 
-    if (game.selected()) {
-        glm::vec3 wpos = boardToWorld(*game.selected());
-        glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(wpos.x, cfg::BOARD_PLANE_Y + 0.01f, wpos.z));
-        M = glm::scale(M, glm::vec3(1.5f));
-        m_basicShader.setMat4("model", M);
-        m_basicShader.setVec3("baseColor", glm::vec3(0.2f, 0.8f, 0.2f));
-        m_basicShader.setFloat("alpha", 0.35f);
-        m_fallbackDisc.draw();
+// 界面文字的投影：向右下偏移 2 像素
+static TextEffect textShadowEffect() {
+    TextEffect fx;
+    fx.shadowOffset = glm::vec2(2.0f, -2.0f);
+    fx.shadowAlpha = 1.0f;
+    return fx;
+}
 
-        for (const auto& t : game.legalTargets()) {
-            glm::vec3 wp = boardToWorld(t);
-            glm::mat4 MM = glm::translate(glm::mat4(1.0f), glm::vec3(wp.x, cfg::BOARD_PLANE_Y + 0.01f, wp.z));
-            m_basicShader.setMat4("model", MM);
-            m_basicShader.setVec3("baseColor", glm::vec3(0.2f, 0.5f, 0.9f));
-            m_basicShader.setFloat("alpha", 0.25f);
-            m_fallbackDisc.draw();
-        }
+// 提交一个界面矩形（按提交顺序绘制）；tex 非零时使用纹理
+// 纹理由界面批处理器自行绑定，不进入队列状态，连续的矩形因此能合并为一次绘制
+void Renderer::submitUiRect(RenderPass pass, const UiRect& r, const glm::vec3& color, float alpha, GLuint tex, bool texAlpha) {
+    RenderCommand cmd;
+    cmd.kind = RenderCommandKind::UiRect;
+    cmd.state.shader = shaderKey(ShaderId::Ui, 0);
+    cmd.state.depthTest = false;
+    cmd.state.depthWrite = false;
+    cmd.flags = texAlpha ? 1 : 0;
+    cmd.payload = tex;
+    cmd.transform = glm::translate(glm::mat4(1.0f), glm::vec3(r.x, r.y, 0.0f));
+    cmd.transform = glm::scale(cmd.transform, glm::vec3(r.w, r.h, 1.0f));
+    cmd.color = glm::vec4(color, alpha);
+    m_queue.submitOrdered(pass, cmd);
+}
+
+// 提交一段文字到界面通道；文字本体存在复用的文字表中
+void Renderer::submitText(std::string_view text, float x, float y, float scale, const glm::vec3& color,
+                          const TextEffect& effect) {
+    if (m_textCount == m_texts.size()) m_texts.emplace_back();
+    QueuedText& t = m_texts[m_textCount];
+    t.text.assign(text.data(), text.size());
+    t.x = x;
+    t.y = y;
+    t.scale = scale;
+    t.color = color;
+    t.effect = effect;
+
+    RenderCommand cmd;
+    cmd.kind = RenderCommandKind::Text;
+    cmd.state.shader = shaderKey(ShaderId::Text, 0);
+    cmd.state.depthTest = false;
+    cmd.state.depthWrite = false;
+    cmd.payload = (uint32_t)m_textCount++;
+    m_queue.submitOrdered(RenderPass::Overlay, cmd);
+}
+
+// 提交带右下投影的文字：距离场模式在同一个四边形内合成阴影，位图模式提交两遍
+void Renderer::submitShadowedText(std::string_view text, float x, float y, float scale, const glm::vec3& color) {
+    if (m_text.sdf()) {
+        submitText(text, x, y, scale, color, textShadowEffect());
+        return;
     }
+    submitText(text, x + 2.0f, y - 2.0f, scale, glm::vec3(0.05f, 0.05f, 0.05f));
+    submitText(text, x, y, scale, color);
+}
 
-    m_basicShader.setFloat("roughness", cfg::PIECE_ROUGHNESS);
-    m_basicShader.setFloat("metalness", cfg::PIECE_METALNESS);
-    m_basicShader.setInt("useTextureAlpha", 0);
-    m_basicShader.setInt("albedoMap", 0);
-    for (const auto& mv : moves) {
-        const Model* model = getPieceModelOrNull(pieceKey(mv.piece));
-        if (!model) continue;
+// 排序并执行本帧队列，记录状态切换统计
+void Renderer::flushQueue() {
+    m_queue.sort();
+    RenderQueueStats qs = m_queue.execute(*this);
+    m_stats.queueCommands = qs.commands;
+    m_stats.shaderChanges = qs.shaderChanges;
+    m_stats.textureChanges = qs.textureChanges;
+    m_stats.stateChanges = qs.blendChanges + qs.depthChanges + qs.cullChanges;
+    m_queue.clear();
+    m_textCount = 0;
+
+    // 恢复默认状态，保证下一帧的清屏与队列外的绘制不受影响
+    glDepthMask(GL_TRUE);
+    glDisable(GL_CULL_FACE);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
 
-        glm::vec3 wpos = moveWorldPos(mv);
-
-        m_basicShader.use();
-        m_basicShader.setMat4("view", V);
-        m_basicShader.setMat4("projection", P);
-        m_basicShader.setVec3("lightDir", lightDir);
-        m_basicShader.setVec3("viewPos", cam.position());
-        m_basicShader.setFloat("roughness", cfg::PIECE_ROUGHNESS);
-        m_basicShader.setFloat("metalness", cfg::PIECE_METALNESS);
-        m_basicShader.setInt("useShadow", 0);
-        m_basicShader.setInt("useNormalMap", 0);
-        m_basicShader.setInt("useTextureAlpha", 0);
-        m_basicShader.setFloat("alpha", 1.0f);
-
-        if (model->hasAlbedo()) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, model->albedoId());
-            m_basicShader.setInt("useTexture", 1);
-            m_basicShader.setVec3("baseColor", glm::vec3(1.0f));
-        } else {
-            m_basicShader.setInt("useTexture", 0);
-            m_basicShader.setVec3("baseColor", sideColor(mv.piece.side));
+// ---- RenderExecutor：把队列命令翻译为 GL 调用 ----
+
+void Renderer::beginPass(RenderPass pass) {
+    m_execMaterial = -1;
+    switch (pass) {
+    case RenderPass::Shadow:
+        glViewport(0, 0, m_shadowSize, m_shadowSize);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_shadowFBO);
+        glDepthMask(GL_TRUE);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        bindSceneFrame();
+        break;
+    case RenderPass::Scene:
+        bindSceneFrame();
+        if (m_shadowReady) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, m_shadowTex);
         }
+        if (m_boardNormal.valid()) {
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, m_boardNormal.id());
+        }
+        if (m_pieceAlbedosReady) {
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, m_pieceAlbedos.id());
+        }
+        glActiveTexture(GL_TEXTURE0);
+        break;
+    case RenderPass::Background:
+    case RenderPass::Overlay:
+    default:
+        m_frameUbo.bindRange(UBO_BINDING_FRAME, m_uiFrameOffset, sizeof(FrameUniforms));
+        break;
+    }
+}
 
-        glm::mat4 M = glm::translate(glm::mat4(1.0f), wpos);
-        M = glm::scale(M, glm::vec3(cfg::PIECE_MODEL_SCALE));
-        M = M * model->suggestedTransform();
-        m_basicShader.setMat4("model", M);
-        model->draw();
-        if (model->hasAlbedo()) {
+void Renderer::endPass(RenderPass pass) {
+    m_ui.flush();
+    m_text.flush();
+    if (pass == RenderPass::Shadow) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, m_w, m_h);
+    } else if (pass == RenderPass::Scene) {
+        if (m_pieceAlbedosReady) {
+            glActiveTexture(GL_TEXTURE3);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        }
+        if (m_boardNormal.valid()) {
+            glActiveTexture(GL_TEXTURE2);
             glBindTexture(GL_TEXTURE_2D, 0);
         }
+        if (m_shadowReady) {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        glActiveTexture(GL_TEXTURE0);
     }
+}
 
-    for (int y = 0; y < 10; ++y) {
-        for (int x = 0; x < 9; ++x) {
-            if (!b.cells[y][x]) continue;
-            Pos pos{x, y};
-            if (isMoveTarget(pos)) continue;
+void Renderer::setShader(uint8_t shader) {
+    // 连续的文字/界面命令各自合并为一批；离开对应程序前先绘制
+    if (m_execShader == ShaderId::Text) m_text.flush();
+    if (m_execShader == ShaderId::Ui) m_ui.flush();
+    m_execShader = (ShaderId)(shader >> 4);
+    m_execU = nullptr;
+    switch (m_execShader) {
+    case ShaderId::Basic:
+    case ShaderId::Piece:
+    case ShaderId::PieceArray:
+        m_execU = useVariant(m_execShader, shader & 0xFu);
+        break;
+    case ShaderId::Line:
+        m_lineShader.use();
+        break;
+    case ShaderId::Shadow:
+        m_shadowShader.use();
+        break;
+    case ShaderId::Text:
+        break; // TextRenderer 在 flush 时自行绑定程序与图集
+    case ShaderId::Ui:
+        break; // UiBatcher 在 flush 时自行绑定程序与纹理
+    }
+}
 
-            Piece p = *b.cells[y][x];
+void Renderer::setTexture(uint32_t texture) {
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
 
-            glm::vec3 wpos = boardToWorld(pos);
+void Renderer::setBlend(BlendMode blend) {
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, blend == BlendMode::Additive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+}
 
-            bool selected = game.selected() && *game.selected() == pos;
-            float pulse = selected ? sine01(timeSec * 3.4f) : 0.0f;
-            float scale = selected ? (1.04f + 0.04f * pulse) : 1.0f;
-            float lift = selected ? (0.06f * pulse) : 0.0f;
-            wpos.y += lift;
-
-            m_basicShader.use();
-            m_basicShader.setMat4("view", V);
-            m_basicShader.setMat4("projection", P);
-            m_basicShader.setVec3("lightDir", lightDir);
-            m_basicShader.setVec3("viewPos", cam.position());
-            m_basicShader.setFloat("roughness", cfg::PIECE_ROUGHNESS);
-            m_basicShader.setFloat("metalness", cfg::PIECE_METALNESS);
-            m_basicShader.setInt("useShadow", 0);
-            m_basicShader.setInt("useNormalMap", 0);
-            m_basicShader.setInt("useTextureAlpha", 0);
-            m_basicShader.setFloat("alpha", 1.0f);
+void Renderer::setDepth(bool test, bool write) {
+    if (test) glEnable(GL_DEPTH_TEST);
+    else glDisable(GL_DEPTH_TEST);
+    glDepthMask(write ? GL_TRUE : GL_FALSE);
+}
 
-            const Model* model = getPieceModelOrNull(pieceKey(p));
-            if (!model) {
-                continue;
-            }
+void Renderer::setCull(CullMode cull) {
+    if (cull == CullMode::None) {
+        glDisable(GL_CULL_FACE);
+        return;
+    }
+    glEnable(GL_CULL_FACE);
+    glCullFace(cull == CullMode::Front ? GL_FRONT : GL_BACK);
+}
 
-            if (selected) {
-                glDepthMask(GL_FALSE);
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-                m_basicShader.setInt("useTexture", 0);
-                m_basicShader.setVec3("baseColor", glm::vec3(1.0f, 0.86f, 0.55f));
-                m_basicShader.setFloat("alpha", 0.35f);
-                m_basicShader.setFloat("roughness", 1.0f);
-                m_basicShader.setFloat("metalness", 0.0f);
-                m_basicShader.setInt("useTextureAlpha", 0);
-
-                glm::mat4 glowM = glm::translate(glm::mat4(1.0f), wpos);
-                glowM = glm::scale(glowM, glm::vec3(cfg::PIECE_MODEL_SCALE * scale * 1.08f));
-                glowM = glowM * model->suggestedTransform();
-                m_basicShader.setMat4("model", glowM);
-                model->draw();
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-                glDepthMask(GL_TRUE);
-                m_basicShader.setFloat("roughness", cfg::PIECE_ROUGHNESS);
-                m_basicShader.setFloat("metalness", cfg::PIECE_METALNESS);
-                m_basicShader.setFloat("alpha", 1.0f);
-            }
+void Renderer::draw(const RenderCommand& cmd) {
+    // 只有 basic.frag 系列程序（m_execU 非空）使用材质块
+    if (cmd.material != m_execMaterial && m_execU) {
+        bindMaterial((MaterialPreset)cmd.material);
+        m_execMaterial = cmd.material;
+    }
 
-            if (model->hasAlbedo()) {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, model->albedoId());
-                m_basicShader.setInt("useTexture", 1);
-                m_basicShader.setVec3("baseColor", glm::vec3(1.0f));
-            } else {
-                m_basicShader.setInt("useTexture", 0);
-                m_basicShader.setVec3("baseColor", sideColor(p.side));
-            }
+    switch (cmd.kind) {
+    case RenderCommandKind::Mesh:
+    case RenderCommandKind::Model:
+        m_execU->baseColor.set(glm::vec3(cmd.color));
+        m_execU->alpha.set(cmd.color.a);
+        m_execU->model.set(cmd.transform);
+        if (cmd.kind == RenderCommandKind::Model) cmd.model->draw();
+        else cmd.mesh->draw();
+        break;
+    case RenderCommandKind::UiRect: {
+        // transform 为 translate(x, y) * scale(w, h)
+        UiRect r{cmd.transform[3][0], cmd.transform[3][1], cmd.transform[0][0], cmd.transform[1][1]};
+        m_ui.addRect(r, cmd.color, (GLuint)cmd.payload, cmd.flags != 0);
+        break;
+    }
+    case RenderCommandKind::Instanced:
+        cmd.model->drawInstanced(m_instanceVBO, cmd.first * sizeof(InstanceData), (GLsizei)cmd.count, (int)cmd.payload);
+        break;
+    case RenderCommandKind::Lines:
+        m_lineU.model.set(cmd.transform);
+        m_lineU.color.set(glm::vec3(cmd.color));
+        glBindVertexArray(m_lineVAO);
+        glDrawArrays(GL_LINES, 0, (GLsizei)cmd.count);
+        glBindVertexArray(0);
+        drawCounters().drawCalls++;
+        break;
+    case RenderCommandKind::Text: {
+        const QueuedText& t = m_texts[cmd.payload];
+        m_text.appendText(t.text, t.x, t.y, t.scale, t.color, t.effect);
+        break;
+    }
+    }
+}
 
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), wpos);
-            M = glm::scale(M, glm::vec3(cfg::PIECE_MODEL_SCALE * scale));
-            M = M * model->suggestedTransform();
-            m_basicShader.setMat4("model", M);
-            model->draw();
-            if (model->hasAlbedo()) {
-                glBindTexture(GL_TEXTURE_2D, 0);
-            }
-        }
+// 主渲染入口：收集本帧全部绘制到渲染队列，排序后统一执行
+void Renderer::draw(const OrbitCamera& cam, const XiangqiGame& game) {
+    Shader::resetUniformStats();
+    drawCounters() = DrawCounters{};
+    m_text.resetLayoutStats();
+    m_ui.resetStats();
+    m_stats = RenderStats{};
+
+    if (!m_boardLoaded) {
+        glViewport(0, 0, m_w, m_h);
+        glClearColor(0.08f, 0.08f, 0.10f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        captureStats();
+        return;
     }
 
-    for (const auto& c : game.captures()) {
-        float k = (c.duration > 0.0f) ? std::min(1.0f, c.t / c.duration) : 1.0f;
-        float alpha = 1.0f - k;
-        float sc = 1.0f - 0.7f * k;
-        glm::vec3 wpos = boardToWorld(c.pos);
-        wpos.y -= 0.15f * k;
+    glViewport(0, 0, m_w, m_h);
+    glFrontFace(GL_CCW);
+    glClearColor(0.12f, 0.12f, 0.14f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        m_basicShader.use();
-        m_basicShader.setMat4("view", V);
-        m_basicShader.setMat4("projection", P);
-        m_basicShader.setVec3("lightDir", lightDir);
-        m_basicShader.setVec3("viewPos", cam.position());
-        m_basicShader.setFloat("roughness", cfg::PIECE_ROUGHNESS);
-        m_basicShader.setFloat("metalness", cfg::PIECE_METALNESS);
-        m_basicShader.setInt("useShadow", 0);
-        m_basicShader.setInt("useNormalMap", 0);
-        m_basicShader.setInt("useTextureAlpha", 0);
-        m_basicShader.setFloat("alpha", alpha);
+    // 相机/光照常量：每帧上传一次，所有场景着色器共享
+    FrameUniforms frame;
+    frame.view = cam.view();
+    frame.projection = cam.projection((float)m_w / (float)m_h);
+    frame.lightDir = glm::normalize(glm::vec3(-1.0f, -1.5f, -0.8f));
+    frame.lightSpaceMatrix = makeLightSpaceMatrix(frame.lightDir);
+    frame.viewPos = cam.position();
+    frame.time = game.timeSeconds();
+    uploadFrameUniforms(frame);
+
+    PieceView view;
+    view.camera = Frustum(frame.projection * frame.view);
+    view.light = Frustum(frame.lightSpaceMatrix);
+    view.eye = frame.viewPos;
+    view.pixelsPerUnit = 0.5f * (float)m_h * frame.projection[1][1]; // 视口高度 / (2 tan(fovy/2))
+    gatherPieceInstances(game, view);
+    uploadInstances();
+    m_shadowReady = (m_shadowFBO != 0 && m_shadowTex != 0);
+
+    const glm::vec3 camPos = frame.viewPos;
+    auto depthOf = [&](const glm::vec3& p) {
+        return glm::length(p - camPos) / QUEUE_DEPTH_RANGE;
+    };
+    auto batchDepth = [&](const InstanceBatch& batch) {
+        return depthOf(glm::vec3(m_instances[batch.first].model[3]));
+    };
 
-        const Model* model = getPieceModelOrNull(pieceKey(c.piece));
-        if (!model) {
-            continue;
+    if (m_gameBg.valid()) {
+        submitUiRect(RenderPass::Background, UiRect{0.0f, 0.0f, (float)m_w, (float)m_h}, glm::vec3(1.0f), 0.54f, m_gameBg.id());
+    }
+
+    // 阴影：光源视锥内的不透明棋子，剔除正面；输入未变时沿用缓存的深度贴图
+    ShadowCacheKey shadowKey = makeShadowKey(game);
+    for (const auto& batch : m_shadowBatches) {
+        shadowKey.lodHash = (shadowKey.lodHash ^ (uint64_t)(batch.lod + 1)) * 1099511628211ull;
+        shadowKey.lodHash = (shadowKey.lodHash ^ (uint64_t)batch.count) * 1099511628211ull;
+    }
+    bool renderShadow = m_shadowReady && (!m_shadowValid || shadowKey.animating || !(shadowKey == m_shadowKey));
+    countShadowPass(game.timeSeconds(), renderShadow);
+    if (renderShadow) {
+        m_shadowKey = shadowKey;
+        m_shadowValid = true;
+        for (const auto& batch : m_shadowBatches) {
+            RenderCommand cmd;
+            cmd.kind = RenderCommandKind::Instanced;
+            cmd.state.shader = shaderKey(ShaderId::Shadow, 0);
+            cmd.state.cull = CullMode::Front;
+            cmd.model = batch.model;
+            cmd.first = batch.first;
+            cmd.count = (uint32_t)batch.count;
+            cmd.payload = (uint32_t)batch.lod;
+            m_queue.submit(RenderPass::Shadow, false, 0.0f, cmd);
+            m_stats.shadowCasters += (uint32_t)batch.count;
         }
+    } else {
+        m_stats.shadowCulled = 0; // 沿用缓存，本帧没有阴影通道
+    }
 
-        if (model->hasAlbedo()) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, model->albedoId());
-            m_basicShader.setInt("useTexture", 1);
-            m_basicShader.setVec3("baseColor", glm::vec3(1.0f));
+    // 棋盘
+    {
+        RenderCommand cmd;
+        cmd.kind = RenderCommandKind::Model;
+        cmd.model = &m_boardModel;
+        cmd.material = (uint8_t)MaterialPreset::Board;
+        cmd.transform = m_boardModelXform;
+        uint32_t features = (m_boardNormal.valid() ? FEATURE_NORMAL_MAP : 0u) | (m_shadowReady ? FEATURE_SHADOW : 0u);
+        if (cfg::BOARD_USE_ALBEDO && m_boardModel.hasAlbedo()) {
+            cmd.state.texture = m_boardModel.albedoId();
+            cmd.color = glm::vec4(1.0f);
+            features |= FEATURE_TEXTURE;
         } else {
-            m_basicShader.setInt("useTexture", 0);
-            m_basicShader.setVec3("baseColor", sideColor(c.piece.side));
+            cmd.color = glm::vec4(0.62f, 0.47f, 0.28f, 1.0f);
         }
+        cmd.state.shader = shaderKey(ShaderId::Basic, features);
+        m_queue.submit(RenderPass::Scene, false, depthOf(glm::vec3(m_boardModelXform[3])), cmd);
+    }
 
-        glm::mat4 M = glm::translate(glm::mat4(1.0f), wpos);
-        M = glm::scale(M, glm::vec3(cfg::PIECE_MODEL_SCALE * sc));
-        M = M * model->suggestedTransform();
-        m_basicShader.setMat4("model", M);
-        model->draw();
-        if (model->hasAlbedo()) {
-            glBindTexture(GL_TEXTURE_2D, 0);
+    if (cfg::BOARD_DRAW_GRID) {
+        RenderCommand cmd;
+        cmd.kind = RenderCommandKind::Lines;
+        cmd.state.shader = shaderKey(ShaderId::Line, 0);
+        cmd.color = glm::vec4(0.15f, 0.10f, 0.06f, 1.0f);
+        cmd.count = (uint32_t)m_lineVertexCount;
+        m_queue.submit(RenderPass::Scene, false, depthOf(glm::vec3(0.0f)), cmd);
+    }
+
+    // 选中标记与可走位置：半透明圆片
+    if (game.selected()) {
+        auto submitDisc = [&](const Pos& p, float scale, const glm::vec4& color) {
+            glm::vec3 wp = boardToWorld(p);
+            glm::vec3 at(wp.x, cfg::BOARD_PLANE_Y + 0.01f, wp.z);
+            RenderCommand cmd;
+            cmd.kind = RenderCommandKind::Mesh;
+            cmd.state.shader = shaderKey(ShaderId::Basic, 0);
+            cmd.state.depthWrite = false;
+            cmd.mesh = &m_fallbackDisc;
+            cmd.material = (uint8_t)MaterialPreset::Flat;
+            cmd.transform = glm::scale(glm::translate(glm::mat4(1.0f), at), glm::vec3(scale));
+            cmd.color = color;
+            m_queue.submit(RenderPass::Scene, true, depthOf(at), cmd);
+        };
+        submitDisc(*game.selected(), 1.5f, glm::vec4(0.2f, 0.8f, 0.2f, 0.35f));
+        for (const auto& t : game.legalTargets()) {
+            submitDisc(t, 1.0f, glm::vec4(0.2f, 0.5f, 0.9f, 0.25f));
         }
     }
 
+    // 棋子：实例化批次；颜色/透明度来自逐实例属性
+    auto submitBatches = [&](const std::vector<InstanceBatch>& batches, bool translucent) {
+        for (const auto& batch : batches) {
+            RenderCommand cmd;
+            cmd.kind = RenderCommandKind::Instanced;
+            if (batch.layered) {
+                cmd.state.shader = shaderKey(ShaderId::PieceArray, 0);
+            } else {
+                cmd.state.texture = batch.model->hasAlbedo() ? batch.model->albedoId() : 0;
+                cmd.state.shader = shaderKey(ShaderId::Piece, cmd.state.texture ? FEATURE_TEXTURE : 0u);
+            }
+            cmd.state.depthWrite = !translucent;
+            cmd.model = batch.model;
+            cmd.material = (uint8_t)MaterialPreset::Piece;
+            cmd.first = batch.first;
+            cmd.count = (uint32_t)batch.count;
+            cmd.payload = (uint32_t)batch.lod;
+            m_queue.submit(RenderPass::Scene, translucent, batchDepth(batch), cmd);
+        }
+    };
+    submitBatches(m_opaqueBatches, false);
+    submitBatches(m_captureBatches, true);
+
+    // 选中光晕：放大的外壳只画背面，棋子本体遮住内部，只留下轮廓外的一圈
+    for (const auto& batch : m_glowBatches) {
+        RenderCommand cmd;
+        cmd.kind = RenderCommandKind::Instanced;
+        cmd.state.shader = shaderKey(ShaderId::Piece, 0);
+        cmd.state.blend = BlendMode::Additive;
+        cmd.state.depthWrite = false;
+        cmd.state.cull = CullMode::Front;
+        cmd.model = batch.model;
+        cmd.material = (uint8_t)MaterialPreset::Flat;
+        cmd.first = batch.first;
+        cmd.count = (uint32_t)batch.count;
+        cmd.payload = (uint32_t)batch.lod;
+        m_queue.submit(RenderPass::Scene, true, batchDepth(batch), cmd);
+    }
+
+    m_stats.pieceInstances = 0;
+    for (const auto& batch : m_opaqueBatches) m_stats.pieceInstances += (uint32_t)batch.count;
+    for (const auto& batch : m_captureBatches) m_stats.pieceInstances += (uint32_t)batch.count;
+    m_stats.pieceBatches = (uint32_t)(m_opaqueBatches.size() + m_captureBatches.size());
+
     // 界面：在左上角显示当前回合与将军状态。
-    glDisable(GL_DEPTH_TEST);
     const std::string status = game.statusTextCN();
     if (!status.empty()) {
         float x = 20.0f;
         float y = (float)m_h - 28.0f;
         float scale = 0.6f;
-        m_text.renderText(status, x + 2.0f, y - 2.0f, scale, glm::vec3(0.05f, 0.05f, 0.05f));
-        m_text.renderText(status, x, y, scale, glm::vec3(0.95f, 0.95f, 0.95f));
+        submitShadowedText(status, x, y, scale, glm::vec3(0.95f, 0.95f, 0.95f));
     }
 
     {
@@ -785,7 +1381,6 @@ void Renderer::draw(const OrbitCamera& cam, const XiangqiGame& game) {
         float y = (float)m_h - 32.0f;
         float lineGap = 30.0f;
         float scale = 0.52f;
-        glm::vec3 shadow(0.05f, 0.05f, 0.05f);
         glm::vec3 color(0.85f, 0.85f, 0.85f);
 
         TextMetrics m1 = m_text.measureText(line1, scale);
@@ -795,53 +1390,21 @@ void Renderer::draw(const OrbitCamera& cam, const XiangqiGame& game) {
         float x2 = (float)m_w - margin - m2.width;
         float x3 = (float)m_w - margin - m3.width;
 
-        m_text.renderText(line1, x1 + 2.0f, y - 2.0f, scale, shadow);
-        m_text.renderText(line1, x1, y, scale, color);
-        m_text.renderText(line2, x2 + 2.0f, y - lineGap - 2.0f, scale, shadow);
-        m_text.renderText(line2, x2, y - lineGap, scale, color);
-        m_text.renderText(line3, x3 + 2.0f, y - lineGap * 2.0f - 2.0f, scale, shadow);
-        m_text.renderText(line3, x3, y - lineGap * 2.0f, scale, color);
+        submitShadowedText(line1, x1, y, scale, color);
+        submitShadowedText(line2, x2, y - lineGap, scale, color);
+        submitShadowedText(line3, x3, y - lineGap * 2.0f, scale, color);
     }
 
     if (game.checkFlashActive() && m_checkOverlay.valid()) {
-        glDisable(GL_DEPTH_TEST);
-        glm::mat4 Vui = glm::mat4(1.0f);
-        glm::mat4 Pui = glm::ortho(0.0f, (float)m_w, 0.0f, (float)m_h);
-
-        m_basicShader.use();
-        m_basicShader.setMat4("view", Vui);
-        m_basicShader.setMat4("projection", Pui);
-        m_basicShader.setVec3("lightDir", glm::vec3(0.0f, 0.0f, -1.0f));
-        m_basicShader.setVec3("viewPos", glm::vec3(0.0f, 0.0f, 1.0f));
-        m_basicShader.setFloat("roughness", 1.0f);
-        m_basicShader.setFloat("metalness", 0.0f);
-        m_basicShader.setInt("useShadow", 0);
-        m_basicShader.setInt("useNormalMap", 0);
-        m_basicShader.setInt("albedoMap", 0);
-        m_basicShader.setInt("useTexture", 1);
-        m_basicShader.setInt("useTextureAlpha", 1);
-        m_basicShader.setVec3("baseColor", glm::vec3(1.0f));
-        m_basicShader.setFloat("alpha", 1.0f);
-
         float w = (float)m_w * (2.0f / 3.0f);
         float h = (float)m_h * (2.0f / 3.0f);
         float x = ((float)m_w - w) * 0.5f;
         float y = ((float)m_h - h) * 0.5f;
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_checkOverlay.id());
-
-        glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
-        M = glm::scale(M, glm::vec3(w, h, 1.0f));
-        m_basicShader.setMat4("model", M);
-        m_uiQuad.draw();
-
-        glBindTexture(GL_TEXTURE_2D, 0);
-        m_basicShader.setInt("useTexture", 0);
+        submitUiRect(RenderPass::Overlay, UiRect{x, y, w, h}, glm::vec3(1.0f), 1.0f, m_checkOverlay.id(), true);
     }
 
     if (game.resultOverlayActive()) {
-        const Texture2D* overlay = nullptr;
+        const TextureRef* overlay = nullptr;
         if (game.winnerSide() == Side::Red) {
             overlay = m_redWinOverlay.valid() ? &m_redWinOverlay : nullptr;
         } else {
@@ -849,69 +1412,17 @@ void Renderer::draw(const OrbitCamera& cam, const XiangqiGame& game) {
         }
 
         if (overlay) {
-            glDisable(GL_DEPTH_TEST);
-            glm::mat4 Vui = glm::mat4(1.0f);
-            glm::mat4 Pui = glm::ortho(0.0f, (float)m_w, 0.0f, (float)m_h);
-
-            m_basicShader.use();
-            m_basicShader.setMat4("view", Vui);
-            m_basicShader.setMat4("projection", Pui);
-            m_basicShader.setVec3("lightDir", glm::vec3(0.0f, 0.0f, -1.0f));
-            m_basicShader.setVec3("viewPos", glm::vec3(0.0f, 0.0f, 1.0f));
-            m_basicShader.setFloat("roughness", 1.0f);
-            m_basicShader.setFloat("metalness", 0.0f);
-            m_basicShader.setInt("useShadow", 0);
-            m_basicShader.setInt("useNormalMap", 0);
-            m_basicShader.setInt("albedoMap", 0);
-            m_basicShader.setInt("useTexture", 1);
-            m_basicShader.setInt("useTextureAlpha", 1);
-            m_basicShader.setVec3("baseColor", glm::vec3(1.0f));
-            m_basicShader.setFloat("alpha", 1.0f);
-
             float w = (float)m_w * 0.6f;
             float h = w * 0.55f;
             float x = ((float)m_w - w) * 0.5f;
             float y = ((float)m_h - h) * 0.5f;
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, overlay->id());
-
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f));
-            M = glm::scale(M, glm::vec3(w, h, 1.0f));
-            m_basicShader.setMat4("model", M);
-            m_uiQuad.draw();
-
-            glBindTexture(GL_TEXTURE_2D, 0);
-            m_basicShader.setInt("useTexture", 0);
-            m_basicShader.setInt("useTextureAlpha", 0);
+            submitUiRect(RenderPass::Overlay, UiRect{x, y, w, h}, glm::vec3(1.0f), 1.0f, overlay->id(), true);
         }
     }
 
     if (game.resultPromptActive()) {
-        glDisable(GL_DEPTH_TEST);
-        glm::mat4 Vui = glm::mat4(1.0f);
-        glm::mat4 Pui = glm::ortho(0.0f, (float)m_w, 0.0f, (float)m_h);
-
-        m_basicShader.use();
-        m_basicShader.setMat4("view", Vui);
-        m_basicShader.setMat4("projection", Pui);
-        m_basicShader.setVec3("lightDir", glm::vec3(0.0f, 0.0f, -1.0f));
-        m_basicShader.setVec3("viewPos", glm::vec3(0.0f, 0.0f, 1.0f));
-        m_basicShader.setFloat("roughness", 1.0f);
-        m_basicShader.setFloat("metalness", 0.0f);
-        m_basicShader.setInt("useShadow", 0);
-        m_basicShader.setInt("useNormalMap", 0);
-        m_basicShader.setInt("albedoMap", 0);
-        m_basicShader.setInt("useTexture", 0);
-        m_basicShader.setInt("useTextureAlpha", 0);
-
         auto drawRect = [&](const UiRect& r, const glm::vec3& color, float alpha) {
-            glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(r.x, r.y, 0.0f));
-            M = glm::scale(M, glm::vec3(r.w, r.h, 1.0f));
-            m_basicShader.setMat4("model", M);
-            m_basicShader.setVec3("baseColor", color);
-            m_basicShader.setFloat("alpha", alpha);
-            m_uiQuad.draw();
+            submitUiRect(RenderPass::Overlay, r, color, alpha);
         };
 
         UiRect dim{0.0f, 0.0f, (float)m_w, (float)m_h};
@@ -962,23 +1473,29 @@ void Renderer::draw(const OrbitCamera& cam, const XiangqiGame& game) {
         TextMetrics tm = m_text.measureText(title, titleScale);
         float tx = panel.x + (panel.w - tm.width) * 0.5f;
         float ty = panel.y + panel.h - 62.0f;
-        m_text.renderText(title, tx + 2.0f, ty - 2.0f, titleScale, glm::vec3(0.05f, 0.05f, 0.05f));
-        m_text.renderText(title, tx, ty, titleScale, glm::vec3(0.95f, 0.95f, 0.95f));
+        submitShadowedText(title, tx, ty, titleScale, glm::vec3(0.95f, 0.95f, 0.95f));
 
         TextMetrics rm = m_text.measureText(restartLabel, btnScale);
         float rx = restart.x + (restart.w - rm.width) * 0.5f;
         float ry = restart.y + restart.h * 0.5f + (rm.descent - rm.ascent) * 0.5f;
-        m_text.renderText(restartLabel, rx, ry, btnScale, glm::vec3(0.95f, 0.95f, 0.95f));
+        submitText(restartLabel, rx, ry, btnScale, glm::vec3(0.95f, 0.95f, 0.95f));
 
         TextMetrics em = m_text.measureText(exitLabel, btnScale);
         float ex = exit.x + (exit.w - em.width) * 0.5f;
         float ey = exit.y + exit.h * 0.5f + (em.descent - em.ascent) * 0.5f;
-        m_text.renderText(exitLabel, ex, ey, btnScale, glm::vec3(0.95f, 0.95f, 0.95f));
+        submitText(exitLabel, ex, ey, btnScale, glm::vec3(0.95f, 0.95f, 0.95f));
     }
+
+    flushQueue();
+    captureStats();
 }
 
 // 绘制主菜单
 void Renderer::drawMenu(const MenuLayout& layout, bool hoverStart, bool hoverExit, bool startEnabled) {
+    drawCounters() = DrawCounters{};
+    m_text.resetLayoutStats();
+    m_ui.resetStats();
+    m_stats = RenderStats{};
     glViewport(0, 0, m_w, m_h);
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_CULL_FACE);
@@ -988,45 +1505,16 @@ void Renderer::drawMenu(const MenuLayout& layout, bool hoverStart, bool hoverExi
     glClearColor(0.08f, 0.08f, 0.10f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glm::mat4 V = glm::mat4(1.0f);
-    glm::mat4 P = glm::ortho(0.0f, (float)m_w, 0.0f, (float)m_h);
-
-    m_basicShader.use();
-    m_basicShader.setMat4("view", V);
-    m_basicShader.setMat4("projection", P);
-    m_basicShader.setVec3("lightDir", glm::vec3(0.0f, 0.0f, -1.0f));
-    m_basicShader.setVec3("viewPos", glm::vec3(0.0f, 0.0f, 1.0f));
-    m_basicShader.setInt("useTexture", 0);
-    m_basicShader.setFloat("alpha", 1.0f);
-    m_basicShader.setFloat("roughness", 1.0f);
-    m_basicShader.setFloat("metalness", 0.0f);
-    m_basicShader.setInt("useShadow", 0);
-    m_basicShader.setInt("useNormalMap", 0);
-    m_basicShader.setInt("useTextureAlpha", 0);
-    m_basicShader.setInt("albedoMap", 0);
+    Shader::resetUniformStats();
+    uploadFrameUniforms(FrameUniforms{});
 
     auto drawRect = [&](const UiRect& r, const glm::vec3& color, float alpha) {
-        glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(r.x, r.y, 0.0f));
-        M = glm::scale(M, glm::vec3(r.w, r.h, 1.0f));
-        m_basicShader.setMat4("model", M);
-        m_basicShader.setVec3("baseColor", color);
-        m_basicShader.setFloat("alpha", alpha);
-        m_uiQuad.draw();
+        submitUiRect(RenderPass::Overlay, r, color, alpha);
     };
 
     auto drawTexturedRect = [&](const UiRect& r, GLuint tex) {
         if (!tex) return;
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, tex);
-        m_basicShader.setInt("useTexture", 1);
-        m_basicShader.setVec3("baseColor", glm::vec3(1.0f));
-        m_basicShader.setFloat("alpha", 1.0f);
-        glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(r.x, r.y, 0.0f));
-        M = glm::scale(M, glm::vec3(r.w, r.h, 1.0f));
-        m_basicShader.setMat4("model", M);
-        m_uiQuad.draw();
-        glBindTexture(GL_TEXTURE_2D, 0);
-        m_basicShader.setInt("useTexture", 0);
+        submitUiRect(RenderPass::Overlay, r, glm::vec3(1.0f), 1.0f, tex);
     };
 
     if (m_menuBg.valid()) {
@@ -1083,17 +1571,25 @@ void Renderer::drawMenu(const MenuLayout& layout, bool hoverStart, bool hoverExi
     TextMetrics startMetrics = m_text.measureText(startLabel, textScale);
     float startX = layout.start.x + (layout.start.w - startMetrics.width) * 0.5f;
     float startY = layout.start.y + layout.start.h * 0.5f + (startMetrics.descent - startMetrics.ascent) * 0.5f;
-    m_text.renderText(startLabel, startX, startY, textScale,
+    submitText(startLabel, startX, startY, textScale,
         startEnabled ? glm::vec3(0.96f, 0.94f, 0.90f) : glm::vec3(0.70f, 0.68f, 0.64f));
 
     TextMetrics exitMetrics = m_text.measureText(exitLabel, textScale);
     float exitX = layout.exit.x + (layout.exit.w - exitMetrics.width) * 0.5f;
     float exitY = layout.exit.y + layout.exit.h * 0.5f + (exitMetrics.descent - exitMetrics.ascent) * 0.5f;
-    m_text.renderText(exitLabel, exitX, exitY, textScale, glm::vec3(0.96f, 0.94f, 0.90f));
+    submitText(exitLabel, exitX, exitY, textScale, glm::vec3(0.96f, 0.94f, 0.90f));
+
+    flushQueue();
+    captureStats();
 }
 
 // 绘制加载中提示
 void Renderer::drawLoading(const std::string& message) {
+    Shader::resetUniformStats();
+    drawCounters() = DrawCounters{};
+    m_text.resetLayoutStats();
+    m_ui.resetStats();
+    m_stats = RenderStats{};
     glViewport(0, 0, m_w, m_h);
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_CULL_FACE);
@@ -1107,6 +1603,39 @@ void Renderer::drawLoading(const std::string& message) {
     TextMetrics tm = m_text.measureText(message, scale);
     float x = ((float)m_w - tm.width) * 0.5f;
     float y = ((float)m_h * 0.5f) + (tm.descent - tm.ascent) * 0.5f;
-    m_text.renderText(message, x + 2.0f, y - 2.0f, scale, glm::vec3(0.05f, 0.05f, 0.05f));
-    m_text.renderText(message, x, y, scale, glm::vec3(0.95f, 0.95f, 0.95f));
+    if (m_text.sdf()) {
+        m_text.appendText(message, x, y, scale, glm::vec3(0.95f, 0.95f, 0.95f), textShadowEffect());
+    } else {
+        m_text.appendText(message, x + 2.0f, y - 2.0f, scale, glm::vec3(0.05f, 0.05f, 0.05f));
+        m_text.appendText(message, x, y, scale, glm::vec3(0.95f, 0.95f, 0.95f));
+    }
+    m_text.flush();
+
+    captureStats();
+}
+
+// 汇总本帧统计
+void Renderer::captureStats() {
+    const DrawCounters& dc = drawCounters();
+    m_stats.drawCalls = (uint32_t)dc.drawCalls;
+    m_stats.triangles = (uint32_t)dc.triangles;
+    m_stats.trianglesLod0 = (uint32_t)(dc.triangles + dc.lodTrianglesSaved);
+    m_stats.vertexKB = (uint32_t)(dc.vertexBytes / 1024);
+    const UniformStats& us = Shader::uniformStats();
+    m_stats.uniformUploads = (uint32_t)us.uploads;
+    m_stats.uniformSkipped = (uint32_t)us.skipped;
+    m_stats.uniformLookups = (uint32_t)us.nameLookups;
+    m_stats.textLayoutHits = m_text.layoutStats().hits;
+    m_stats.textLayoutMisses = m_text.layoutStats().misses;
+    m_stats.uiQuads = m_ui.stats().quads;
+    m_stats.uiBatches = m_ui.stats().batches;
+    m_stats.textureUploadBytes = m_textures.stats().uploadBytes + m_albedoUploadBytes;
+    const auto resources = m_resources.stats();
+    size_t textureBytes = 0;
+    for (ResourceCategory c : {ResourceCategory::UiTexture, ResourceCategory::ModelTexture, ResourceCategory::TextureArray}) {
+        textureBytes += resources[(size_t)c].bytes;
+    }
+    m_stats.gpuTextureKB = (uint32_t)(textureBytes / 1024);
+    m_stats.gpuMeshKB = (uint32_t)(resources[(size_t)ResourceCategory::Mesh].bytes / 1024);
+    m_stats.texturesPending = m_textures.stats().pending;
 }
@@ -0,0 +1,188 @@
+#include "Replay.hpp"
+
+#include "Util.hpp"
+#include "Vfs.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// 解析鼠标按钮名称
+static bool parseButton(const std::string& name, int& out) {
+    if (name == "left")  { out = GLFW_MOUSE_BUTTON_LEFT;  return true; }
+    if (name == "right") { out = GLFW_MOUSE_BUTTON_RIGHT; return true; }
+    return false;
+}
+
+// 解析按键名称（字母/数字/常用功能键）
+static bool parseKey(const std::string& name, int& out) {
+    if (name.size() == 1) {
+        char c = name[0];
+        if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+        if (c >= 'A' && c <= 'Z') { out = GLFW_KEY_A + (c - 'A'); return true; }
+        if (c >= '0' && c <= '9') { out = GLFW_KEY_0 + (c - '0'); return true; }
+    }
+    if (name == "ENTER")    { out = GLFW_KEY_ENTER;    return true; }
+    if (name == "KP_ENTER") { out = GLFW_KEY_KP_ENTER; return true; }
+    if (name == "ESCAPE")   { out = GLFW_KEY_ESCAPE;   return true; }
+    if (name == "SPACE")    { out = GLFW_KEY_SPACE;    return true; }
+    return false;
+}
+
+// 读取并解析回放脚本
+bool ReplayScript::load(const std::string& path) {
+    m_events.clear();
+    m_cursor = 0;
+    m_ended = false;
+    m_error.clear();
+
+    vfs::File data = vfs::open(path);
+    if (!data.valid() && !vfs::exists(path)) { // 空文件 open 无效，但仍是合法脚本
+        m_error = "Failed to open replay script: " + path;
+        return false;
+    }
+
+    std::istringstream file{std::string(data.text())};
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(file, line)) {
+        ++lineNo;
+        auto hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+
+        std::istringstream ss(line);
+        ReplayEvent e;
+        std::string verb;
+        if (!(ss >> e.time)) continue; // 空行
+        if (!(ss >> verb)) {
+            m_error = "Replay line " + std::to_string(lineNo) + ": missing event";
+            return false;
+        }
+
+        bool ok = true;
+        if (verb == "move") {
+            e.type = ReplayEventType::MouseMove;
+            ok = (bool)(ss >> e.x >> e.y);
+        } else if (verb == "down" || verb == "up") {
+            e.type = (verb == "down") ? ReplayEventType::MouseDown : ReplayEventType::MouseUp;
+            std::string button;
+            ok = (ss >> button) && parseButton(button, e.code);
+        } else if (verb == "scroll") {
+            e.type = ReplayEventType::Scroll;
+            ok = (bool)(ss >> e.y);
+        } else if (verb == "key") {
+            e.type = ReplayEventType::Key;
+            std::string key;
+            ok = (ss >> key) && parseKey(key, e.code);
+        } else if (verb == "camera") {
+            e.type = ReplayEventType::Camera;
+            ok = (bool)(ss >> e.x >> e.y >> e.z);
+        } else if (verb == "end") {
+            e.type = ReplayEventType::End;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            m_error = "Replay line " + std::to_string(lineNo) + ": bad event '" + verb + "'";
+            return false;
+        }
+        m_events.push_back(e);
+    }
+
+    // 同一时间的事件保持脚本中的先后顺序
+    std::stable_sort(m_events.begin(), m_events.end(), [](const ReplayEvent& a, const ReplayEvent& b) {
+        return a.time < b.time;
+    });
+    return true;
+}
+
+const ReplayEvent* ReplayScript::next(double simTime) {
+    if (m_ended || m_cursor >= m_events.size()) return nullptr;
+    const ReplayEvent& e = m_events[m_cursor];
+    if (e.time > simTime) return nullptr;
+    ++m_cursor;
+    if (e.type == ReplayEventType::End) m_ended = true;
+    return &e;
+}
+
+bool ReplayScript::finished() const {
+    return m_ended || m_cursor >= m_events.size();
+}
+
+double ReplayScript::duration() const {
+    return m_events.empty() ? 0.0 : m_events.back().time;
+}
+
+// 写出逐帧耗时
+bool FrameStats::writeCsv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        util::logWarn("Failed to write frame timings: " + path);
+        return false;
+    }
+    out << "frame,sim_time,update_ms,render_ms,total_ms";
+    RenderStats{}.forEach([&](const char* name, uint32_t) { out << ',' << name; });
+    out << '\n';
+
+    char buf[160];
+    for (size_t i = 0; i < m_frames.size(); ++i) {
+        const FrameTiming& f = m_frames[i];
+        std::snprintf(buf, sizeof(buf), "%zu,%.4f,%.4f,%.4f,%.4f",
+            i, f.simTime, f.updateMs, f.renderMs, f.totalMs);
+        out << buf;
+        f.render.forEach([&](const char*, uint32_t v) { out << ',' << v; });
+        out << '\n';
+    }
+    return true;
+}
+
+// 汇总帧耗时分布
+std::string FrameStats::summary() const {
+    if (m_frames.empty()) return "frames=0";
+
+    std::vector<double> total;
+    total.reserve(m_frames.size());
+    double sumUpdate = 0.0, sumRender = 0.0, sumTotal = 0.0;
+    for (const auto& f : m_frames) {
+        total.push_back(f.totalMs);
+        sumUpdate += f.updateMs;
+        sumRender += f.renderMs;
+        sumTotal += f.totalMs;
+    }
+    std::sort(total.begin(), total.end());
+
+    auto pct = [&](double p) {
+        size_t i = (size_t)(p * (double)(total.size() - 1) + 0.5);
+        return total[std::min(i, total.size() - 1)];
+    };
+
+    double n = (double)m_frames.size();
+    char buf[320];
+    std::snprintf(buf, sizeof(buf),
+        "frames=%zu avg=%.3fms (update %.3f, render %.3f) min=%.3f p50=%.3f p95=%.3f p99=%.3f max=%.3f",
+        m_frames.size(), sumTotal / n, sumUpdate / n, sumRender / n,
+        total.front(), pct(0.50), pct(0.95), pct(0.99), total.back());
+
+    // 渲染计数：每帧平均
+    std::vector<double> sums;
+    for (const auto& f : m_frames) {
+        size_t k = 0;
+        f.render.forEach([&](const char*, uint32_t v) {
+            if (k >= sums.size()) sums.push_back(0.0);
+            sums[k++] += (double)v;
+        });
+    }
+    std::string out = buf;
+    size_t k = 0;
+    RenderStats{}.forEach([&](const char* name, uint32_t) {
+        char item[96];
+        std::snprintf(item, sizeof(item), "%s%s=%.1f", k == 0 ? "\n  per frame: " : " ", name, sums[k] / n);
+        out += item;
+        ++k;
+    });
+    return out;
+}
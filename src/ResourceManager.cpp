@@ -0,0 +1,141 @@
+#include "ResourceManager.hpp"
+
+#include "Util.hpp"
+#include "Vfs.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+uint64_t contentHash(const void* data, size_t bytes, uint64_t h) {
+    const unsigned char* c = static_cast<const unsigned char*>(data);
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, c + i, 8);
+        h = (h ^ w) * 1099511628211ull;
+    }
+    for (; i < bytes; ++i) h = (h ^ c[i]) * 1099511628211ull;
+    return h;
+}
+
+const char* resourceCategoryName(ResourceCategory c) {
+    switch (c) {
+    case ResourceCategory::UiTexture: return "ui_texture";
+    case ResourceCategory::ModelTexture: return "model_texture";
+    case ResourceCategory::TextureArray: return "texture_array";
+    case ResourceCategory::Mesh: return "mesh";
+    case ResourceCategory::RenderTarget: return "render_target";
+    default: return "unknown";
+    }
+}
+
+// RGBA8 纹理的显存估计：完整 mip 链约为基础层的 4/3
+static size_t textureBytes(const Texture2D& t, bool mip) {
+    size_t base = (size_t)t.width() * (size_t)t.height() * 4;
+    return mip ? base + base / 3 : base;
+}
+
+TextureRef ResourceManager::acquireTexture(uint64_t hash, ResourceCategory category, bool mip,
+                                           const std::function<Texture2D()>& create) {
+    TextureEntry& e = m_textures[hash];
+    if (auto live = e.texture.lock()) {
+        e.hits++;
+        m_hits[(size_t)e.category]++;
+        return TextureRef(std::move(live));
+    }
+
+    auto texture = std::make_shared<const Texture2D>(create());
+    if (texture->id() == 0) {
+        m_textures.erase(hash);
+        return TextureRef();
+    }
+    e = TextureEntry{texture, category, mip, 0};
+    return TextureRef(std::move(texture));
+}
+
+TextureRef ResourceManager::loadTexture(const std::string& path, ResourceCategory category, bool mip) {
+    vfs::File file = vfs::open(path);
+    if (!file.valid()) return TextureRef();
+    const uint64_t hash = contentHash(file.data(), file.size());
+    return acquireTexture(hash, category, mip, [&] {
+        if (!m_streamer) return Texture2D::fromMemory(file.data(), (int)file.size(), mip);
+        return Texture2D::fromEncodedAsync(*m_streamer, std::vector<unsigned char>(file.data(), file.data() + file.size()), path, mip);
+    });
+}
+
+MeshRef ResourceManager::acquireMesh(uint64_t hash, const std::function<Mesh()>& create) {
+    MeshEntry& e = m_meshes[hash];
+    if (auto live = e.mesh.lock()) {
+        e.hits++;
+        m_hits[(size_t)ResourceCategory::Mesh]++;
+        return live;
+    }
+
+    auto mesh = std::make_shared<const Mesh>(create());
+    e = MeshEntry{mesh, 0};
+    return mesh;
+}
+
+void ResourceManager::setExternalBytes(const std::string& name, ResourceCategory category, size_t bytes) {
+    if (bytes == 0) {
+        m_external.erase(name);
+        return;
+    }
+    m_external[name] = ExternalEntry{category, bytes};
+}
+
+std::array<ResourceCategoryStats, (size_t)ResourceCategory::Count> ResourceManager::stats() const {
+    std::array<ResourceCategoryStats, (size_t)ResourceCategory::Count> out{};
+    for (size_t i = 0; i < out.size(); ++i) out[i].dedupHits = m_hits[i];
+
+    for (const auto& [hash, e] : m_textures) {
+        auto live = e.texture.lock();
+        if (!live) continue;
+        ResourceCategoryStats& s = out[(size_t)e.category];
+        const size_t bytes = textureBytes(*live, e.mip);
+        s.resources++;
+        s.handles += (uint32_t)live.use_count() - 1; // 不计本处的临时引用
+        s.bytes += bytes;
+        s.savedBytes += bytes * e.hits;
+    }
+    for (const auto& [hash, e] : m_meshes) {
+        auto live = e.mesh.lock();
+        if (!live) continue;
+        ResourceCategoryStats& s = out[(size_t)ResourceCategory::Mesh];
+        const size_t bytes = live->vertexBytes() + live->indexBytes();
+        s.resources++;
+        s.handles += (uint32_t)live.use_count() - 1;
+        s.bytes += bytes;
+        s.savedBytes += bytes * e.hits;
+    }
+    for (const auto& [name, e] : m_external) {
+        ResourceCategoryStats& s = out[(size_t)e.category];
+        s.resources++;
+        s.handles++;
+        s.bytes += e.bytes;
+    }
+    return out;
+}
+
+size_t ResourceManager::totalBytes(ResourceCategory category) const {
+    return stats()[(size_t)category].bytes;
+}
+
+void ResourceManager::logStats() const {
+    const auto all = stats();
+    size_t total = 0, saved = 0;
+    for (size_t i = 0; i < all.size(); ++i) {
+        const ResourceCategoryStats& s = all[i];
+        total += s.bytes;
+        saved += s.savedBytes;
+        char buf[192];
+        std::snprintf(buf, sizeof(buf), "Resources %-13s count=%u handles=%u dedup_hits=%u gpu_kb=%.1f saved_kb=%.1f",
+            resourceCategoryName((ResourceCategory)i), s.resources, s.handles, s.dedupHits,
+            (double)s.bytes / 1024.0, (double)s.savedBytes / 1024.0);
+        util::logInfo(buf);
+    }
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "Resources total gpu_kb=%.1f saved_kb=%.1f", (double)total / 1024.0, (double)saved / 1024.0);
+    util::logInfo(buf);
+}
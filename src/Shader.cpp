@@ -1,8 +1,14 @@
 #include "Shader.hpp"
 
+#include "UniformBuffer.hpp"
 #include "Util.hpp"
+#include "Vfs.hpp"
 
+#include <cstring>
 #include <stdexcept>
+#include <utility>
+
+static UniformStats g_uniformStats;
 
 // 编译单个着色器
 static GLuint compile(GLenum type, const std::string& src) {
@@ -25,10 +31,32 @@ static GLuint compile(GLenum type, const std::string& src) {
     return s;
 }
 
+// 在 #version 行之后插入宏定义（#version 必须是第一条指令）
+static std::string injectDefines(const std::string& src, const std::vector<std::string>& defines) {
+    if (defines.empty()) return src;
+    std::string block;
+    for (const auto& d : defines) {
+        block += "#define ";
+        block += d;
+        block += '\n';
+    }
+    size_t at = 0;
+    size_t version = src.find("#version");
+    if (version != std::string::npos) {
+        size_t eol = src.find('\n', version);
+        at = (eol == std::string::npos) ? src.size() : eol + 1;
+    }
+    std::string out = src.substr(0, at);
+    if (!out.empty() && out.back() != '\n') out += '\n';
+    out += block;
+    out.append(src, at, std::string::npos);
+    return out;
+}
+
 // 读取源码，编译并链接程序
-Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
-    std::string vs = util::readTextFile(vertexPath);
-    std::string fs = util::readTextFile(fragmentPath);
+Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath, const std::vector<std::string>& defines) {
+    std::string vs = injectDefines(vfs::readText(vertexPath), defines);
+    std::string fs = injectDefines(vfs::readText(fragmentPath), defines);
 
     GLuint v = compile(GL_VERTEX_SHADER, vs);
     GLuint f = compile(GL_FRAGMENT_SHADER, fs);
@@ -50,6 +78,64 @@ Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath) {
         m_program = 0;
         throw std::runtime_error(std::string("Shader program link failed: ") + log);
     }
+
+    introspect();
+    bindUniformBlocks();
+}
+
+// 按块名把统一缓冲块绑定到固定绑定点（GLSL 3.30 不支持 layout(binding)）
+void Shader::bindUniformBlocks() {
+    GLint count = 0;
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        char name[128];
+        GLsizei len = 0;
+        glGetActiveUniformBlockName(m_program, (GLuint)i, sizeof(name), &len, name);
+        int binding = uniformBlockBinding(std::string(name, (size_t)len));
+        if (binding < 0) {
+            util::logWarn(std::string("Unknown uniform block: ") + name);
+            continue;
+        }
+        glUniformBlockBinding(m_program, (GLuint)i, (GLuint)binding);
+    }
+}
+
+// 遍历活动变量，建立名字到位置的查找表
+void Shader::introspect() {
+    m_uniformIndex.clear();
+    m_slots.clear();
+
+    GLint count = 0;
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+    m_slots.reserve((size_t)count);
+
+    for (GLint i = 0; i < count; ++i) {
+        char name[256];
+        GLsizei len = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_program, (GLuint)i, sizeof(name), &len, &size, &type, name);
+
+        GLint loc = glGetUniformLocation(m_program, name);
+        if (loc < 0) continue; // 统一缓冲块成员没有独立位置
+
+        // 数组变量以 "name[0]" 报告，按基名登记
+        std::string key(name, (size_t)len);
+        auto bracket = key.find('[');
+        if (bracket != std::string::npos) key.erase(bracket);
+
+        UniformSlot slot;
+        slot.location = loc;
+        slot.type = type;
+        m_uniformIndex.emplace(std::move(key), m_slots.size());
+        m_slots.push_back(slot);
+    }
+}
+
+UniformSlot* Shader::findSlot(const std::string& name) const {
+    auto it = m_uniformIndex.find(name);
+    if (it == m_uniformIndex.end()) return nullptr;
+    return &m_slots[it->second];
 }
 
 // 释放着色器程序
@@ -60,8 +146,10 @@ Shader::~Shader() {
     }
 }
 
-Shader::Shader(Shader&& other) noexcept {
-    m_program = other.m_program;
+Shader::Shader(Shader&& other) noexcept
+    : m_program(other.m_program),
+      m_uniformIndex(std::move(other.m_uniformIndex)),
+      m_slots(std::move(other.m_slots)) {
     other.m_program = 0;
 }
 
@@ -69,11 +157,46 @@ Shader& Shader::operator=(Shader&& other) noexcept {
     if (this != &other) {
         if (m_program) glDeleteProgram(m_program);
         m_program = other.m_program;
+        m_uniformIndex = std::move(other.m_uniformIndex);
+        m_slots = std::move(other.m_slots);
         other.m_program = 0;
     }
     return *this;
 }
 
+ShaderVariants::ShaderVariants(std::string vertexPath, std::string fragmentPath, std::vector<std::string> features)
+    : m_vertexPath(std::move(vertexPath)),
+      m_fragmentPath(std::move(fragmentPath)),
+      m_features(std::move(features)) {}
+
+// 取变体；首次使用时按掩码拼出宏定义并编译
+const Shader& ShaderVariants::get(uint32_t mask) {
+    auto it = m_programs.find(mask);
+    if (it != m_programs.end()) return *it->second;
+
+    std::vector<std::string> defines = m_common;
+    for (size_t i = 0; i < m_features.size(); ++i) {
+        if (mask & (1u << i)) defines.push_back(m_features[i]);
+    }
+    std::unique_ptr<Shader> program;
+    try {
+        program = std::make_unique<Shader>(m_vertexPath, m_fragmentPath, defines);
+    } catch (...) {
+        m_failed.insert(mask);
+        throw;
+    }
+    const Shader& ref = *program;
+    m_programs.emplace(mask, std::move(program));
+    return ref;
+}
+
+void ShaderVariants::setCommonDefines(std::vector<std::string> defines) {
+    if (defines == m_common) return;
+    m_common = std::move(defines);
+    m_programs.clear();
+    m_failed.clear();
+}
+
 // 使用当前着色器
 void Shader::use() const {
     glUseProgram(m_program);
@@ -81,30 +204,82 @@ void Shader::use() const {
 
 // 设置四乘四矩阵着色器变量
 void Shader::setMat4(const std::string& name, const glm::mat4& m) const {
-    GLint loc = glGetUniformLocation(m_program, name.c_str());
-    glUniformMatrix4fv(loc, 1, GL_FALSE, &m[0][0]);
+    ++g_uniformStats.nameLookups;
+    uniform<glm::mat4>(name).set(m);
 }
 
 // 设置三维向量着色器变量
 void Shader::setVec3(const std::string& name, const glm::vec3& v) const {
-    GLint loc = glGetUniformLocation(m_program, name.c_str());
-    glUniform3f(loc, v.x, v.y, v.z);
+    ++g_uniformStats.nameLookups;
+    uniform<glm::vec3>(name).set(v);
 }
 
 // 设置四维向量着色器变量
 void Shader::setVec4(const std::string& name, const glm::vec4& v) const {
-    GLint loc = glGetUniformLocation(m_program, name.c_str());
-    glUniform4f(loc, v.x, v.y, v.z, v.w);
+    ++g_uniformStats.nameLookups;
+    uniform<glm::vec4>(name).set(v);
 }
 
 // 设置浮点数着色器变量
 void Shader::setFloat(const std::string& name, float f) const {
-    GLint loc = glGetUniformLocation(m_program, name.c_str());
-    glUniform1f(loc, f);
+    ++g_uniformStats.nameLookups;
+    uniform<float>(name).set(f);
 }
 
 // 设置整数着色器变量
 void Shader::setInt(const std::string& name, int i) const {
-    GLint loc = glGetUniformLocation(m_program, name.c_str());
-    glUniform1i(loc, i);
+    ++g_uniformStats.nameLookups;
+    uniform<int>(name).set(i);
+}
+
+const UniformStats& Shader::uniformStats() {
+    return g_uniformStats;
+}
+
+void Shader::resetUniformStats() {
+    g_uniformStats = UniformStats{};
+}
+
+namespace shader_detail {
+
+void upload(GLint loc, int v) {
+    ++g_uniformStats.uploads;
+    glUniform1i(loc, v);
+}
+
+void upload(GLint loc, float v) {
+    ++g_uniformStats.uploads;
+    glUniform1f(loc, v);
+}
+
+void upload(GLint loc, const glm::vec2& v) {
+    ++g_uniformStats.uploads;
+    glUniform2f(loc, v.x, v.y);
 }
+
+void upload(GLint loc, const glm::vec3& v) {
+    ++g_uniformStats.uploads;
+    glUniform3f(loc, v.x, v.y, v.z);
+}
+
+void upload(GLint loc, const glm::vec4& v) {
+    ++g_uniformStats.uploads;
+    glUniform4f(loc, v.x, v.y, v.z, v.w);
+}
+
+void upload(GLint loc, const glm::mat4& m) {
+    ++g_uniformStats.uploads;
+    glUniformMatrix4fv(loc, 1, GL_FALSE, &m[0][0]);
+}
+
+bool unchanged(UniformSlot& slot, const void* data, size_t size) {
+    if (slot.hasValue && std::memcmp(slot.value, data, size) == 0) {
+        ++g_uniformStats.skipped;
+        return true;
+    }
+    std::memcpy(slot.value, data, size);
+    slot.hasValue = true;
+    return false;
+}
+
+} // namespace shader_detail
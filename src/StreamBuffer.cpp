@@ -0,0 +1,11 @@
+#include "StreamBuffer.hpp"
+
+#include <algorithm>
+
+void uploadStreamBuffer(GLuint vbo, size_t& capacity, const void* data, size_t bytes) {
+    if (bytes > capacity) capacity = std::max(bytes, capacity * 2);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)bytes, data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
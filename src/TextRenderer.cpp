@@ -1,5 +1,7 @@
 #include "TextRenderer.hpp"
 
+#include "RenderStats.hpp"
+#include "StreamBuffer.hpp"
 #include "Util.hpp"
 
 #include <ft2build.h>
@@ -7,11 +9,45 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
-// 释放字形纹理与渲染缓冲
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+// 图集页初始边长与上限（像素）；48px 字号下一页上限约容纳 1500 个汉字
+static constexpr int ATLAS_INITIAL_SIZE = 512;
+static constexpr int ATLAS_MAX_SIZE = 2048;
+// 字形之间留空，避免线性过滤采到相邻字形
+static constexpr int ATLAS_PADDING = 1;
+// 字形栅格化尺寸（像素）；距离场模式下任意缩放都从这一尺寸采样
+static constexpr int GLYPH_PIXEL_SIZE = 48;
+// 距离场扩散范围（图集像素）：限制描边宽度与阴影偏移的上限
+static constexpr int SDF_SPREAD = 6;
+// 排版缓存槽位数（界面同时出现的字符串远少于此）
+static constexpr size_t LAYOUT_CACHE_SIZE = 128;
+
+// 排版缓存键：FNV-1a(文字字节, 缩放位模式)
+static uint64_t layoutHash(std::string_view utf8, float scale) {
+    uint64_t h = 1469598103934665603ull;
+    for (char c : utf8) {
+        h ^= (uint8_t)c;
+        h *= 1099511628211ull;
+    }
+    uint32_t bits = 0;
+    std::memcpy(&bits, &scale, sizeof(bits));
+    for (int i = 0; i < 4; ++i) {
+        h ^= (bits >> (i * 8)) & 0xFFu;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// 释放图集纹理与渲染缓冲
 TextRenderer::~TextRenderer() {
-    for (auto& [cp, g] : m_glyphs) {
-        if (g.texture) glDeleteTextures(1, &g.texture);
+    for (auto& page : m_pages) {
+        if (page.texture) glDeleteTextures(1, &page.texture);
     }
+    m_pages.clear();
     m_glyphs.clear();
 
     if (m_vbo) glDeleteBuffers(1, &m_vbo);
@@ -33,28 +69,61 @@ bool TextRenderer::init(const std::string& fontPath, int viewportW, int viewport
     m_w = viewportW;
     m_h = viewportH;
 
+    // 字体只经 VFS 读一次，主线程与距离场工作线程的 FT_Face 共用
+    m_font = vfs::open(fontPath);
+    if (!m_font.valid()) {
+        util::logWarn(std::string("Failed to load font: ") + fontPath);
+        return false;
+    }
+
+    // 距离场字形由工作线程生成，主线程只负责装箱与上传
+    m_sdf = false;
+    if (m_wantSdf) {
+        unsigned hw = std::thread::hardware_concurrency();
+        unsigned threads = std::min(4u, std::max(1u, hw > 1 ? hw - 1 : 1u));
+        if (!GlyphRasterizer::supported()) {
+            util::logWarn("FreeType lacks SDF rendering, using bitmap glyphs");
+        } else if (!m_rasterizer.start(m_font, GLYPH_PIXEL_SIZE, SDF_SPREAD, threads)) {
+            util::logWarn("SDF glyph workers failed to start, using bitmap glyphs");
+        } else {
+            m_sdf = true;
+        }
+    }
+
     try {
-        m_shader = Shader("assets/shaders/text.vert", "assets/shaders/text.frag");
+        std::vector<std::string> defines;
+        if (m_sdf) defines.push_back("USE_SDF");
+        m_shader = Shader("assets/shaders/text.vert", "assets/shaders/text.frag", defines);
     } catch (const std::exception& e) {
         util::logError(e.what());
+        m_rasterizer.stop();
         return false;
     }
+    m_uProjection = m_shader.uniform<glm::mat4>("projection");
+    m_uText = m_shader.uniform<int>("text");
+
+    m_layouts.reserve(LAYOUT_CACHE_SIZE);
+    m_layoutIndex.reserve(LAYOUT_CACHE_SIZE * 2);
 
     // 初始化字体库并加载字体文件
     FT_Library ft;
     if (FT_Init_FreeType(&ft)) {
         util::logWarn("Failed to init FreeType");
+        m_rasterizer.stop();
+        m_sdf = false;
         return false;
     }
 
     FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
+    if (FT_New_Memory_Face(ft, m_font.data(), (FT_Long)m_font.size(), 0, &face)) {
         util::logWarn(std::string("Failed to load font: ") + fontPath);
         FT_Done_FreeType(ft);
+        m_rasterizer.stop();
+        m_sdf = false;
         return false;
     }
 
-    FT_Set_Pixel_Sizes(face, 0, 48);
+    FT_Set_Pixel_Sizes(face, 0, GLYPH_PIXEL_SIZE);
 
     m_ftLib = (void*)ft;
     m_ftFace = (void*)face;
@@ -64,10 +133,15 @@ bool TextRenderer::init(const std::string& fontPath, int viewportW, int viewport
     glGenBuffers(1, &m_vbo);
     glBindVertexArray(m_vao);
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
+    m_vboCapacity = sizeof(TextVertex) * 6 * 64;
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m_vboCapacity, nullptr, GL_STREAM_DRAW);
 
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, color));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, effect));
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
@@ -75,7 +149,7 @@ bool TextRenderer::init(const std::string& fontPath, int viewportW, int viewport
     // 预加载界面常用字符，减少首次绘制开销
     preload("0123456789()ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz:.- ");
 
-    util::logInfo("TextRenderer ready");
+    util::logInfo(m_sdf ? "TextRenderer ready (SDF glyphs)" : "TextRenderer ready");
     return true;
 }
 
@@ -84,95 +158,344 @@ void TextRenderer::resize(int viewportW, int viewportH) {
     m_h = viewportH;
 }
 
-// 加载单个字形并生成纹理
-bool TextRenderer::loadGlyph(char32_t cp) {
-    if (!m_ftFace) return false;
-    FT_Face face = (FT_Face)m_ftFace;
+// 在页内找位置：选能放下且高度浪费最少的货架，没有则在顶部开新货架
+bool TextRenderer::packIntoPage(GlyphAtlasPage& page, int w, int h, glm::ivec2& pos) const {
+    GlyphAtlasPage::Shelf* best = nullptr;
+    for (auto& shelf : page.shelves) {
+        if (shelf.height < h || shelf.x + w > page.size) continue;
+        if (!best || shelf.height < best->height) best = &shelf;
+    }
+    if (!best) {
+        int top = page.shelves.empty() ? 0 : page.shelves.back().y + page.shelves.back().height;
+        if (top + h > page.size || w > page.size) return false;
+        page.shelves.push_back({top, h, 0});
+        best = &page.shelves.back();
+    }
+    pos = glm::ivec2(best->x, best->y);
+    best->x += w;
+    return true;
+}
 
-    if (FT_Load_Char(face, (FT_ULong)cp, FT_LOAD_RENDER)) {
-        return false;
+// 倍增页尺寸：已放置的字形像素坐标不变，货架获得更多宽度，顶部多出开新货架的空间
+void TextRenderer::growPage(GlyphAtlasPage& page, int newSize) {
+    std::vector<unsigned char> pixels((size_t)newSize * (size_t)newSize, 0);
+    for (int row = 0; row < page.size; ++row) {
+        std::memcpy(pixels.data() + (size_t)row * (size_t)newSize,
+                    page.pixels.data() + (size_t)row * (size_t)page.size, (size_t)page.size);
     }
+    page.pixels.swap(pixels);
+    page.size = newSize;
+    uploadPage(page);
+}
 
+// 按 CPU 副本（重新）分配页纹理
+void TextRenderer::uploadPage(const GlyphAtlasPage& page) {
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, page.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, page.size, page.size, 0, GL_RED, GL_UNSIGNED_BYTE, page.pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// 为 w x h 的位图分配图集位置：依次尝试已有页、倍增最后一页、新开一页
+bool TextRenderer::allocateGlyph(int w, int h, int& page, glm::ivec2& pos) {
+    if (w > ATLAS_MAX_SIZE || h > ATLAS_MAX_SIZE) return false;
 
-    GLuint tex;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
-
-    glTexImage2D(
-        GL_TEXTURE_2D,
-        0,
-        GL_RED,
-        face->glyph->bitmap.width,
-        face->glyph->bitmap.rows,
-        0,
-        GL_RED,
-        GL_UNSIGNED_BYTE,
-        face->glyph->bitmap.buffer
-    );
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (packIntoPage(m_pages[i], w, h, pos)) {
+            page = (int)i;
+            return true;
+        }
+    }
 
+    if (!m_pages.empty()) {
+        GlyphAtlasPage& last = m_pages.back();
+        while (last.size < ATLAS_MAX_SIZE) {
+            growPage(last, last.size * 2);
+            if (packIntoPage(last, w, h, pos)) {
+                page = (int)m_pages.size() - 1;
+                return true;
+            }
+        }
+    }
+
+    GlyphAtlasPage fresh;
+    fresh.size = ATLAS_INITIAL_SIZE;
+    while (fresh.size < w || fresh.size < h) fresh.size *= 2;
+    fresh.pixels.assign((size_t)fresh.size * (size_t)fresh.size, 0);
+    glGenTextures(1, &fresh.texture);
+    glBindTexture(GL_TEXTURE_2D, fresh.texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    uploadPage(fresh);
+    m_pages.push_back(std::move(fresh));
+    m_pageVertices.resize(m_pages.size());
+
+    page = (int)m_pages.size() - 1;
+    return packIntoPage(m_pages.back(), w, h, pos);
+}
+
+// 把位图写入图集并登记字形；pixels 行距为 pitch 字节
+bool TextRenderer::storeGlyph(char32_t cp, Glyph g, const unsigned char* pixels, int pitch) {
+    if (g.size.x > 0 && g.size.y > 0) {
+        if (!allocateGlyph(g.size.x + ATLAS_PADDING, g.size.y + ATLAS_PADDING, g.page, g.atlasPos)) {
+            util::logWarn("Glyph does not fit into atlas");
+            return false;
+        }
+
+        GlyphAtlasPage& page = m_pages[(size_t)g.page];
+        for (int row = 0; row < g.size.y; ++row) {
+            std::memcpy(page.pixels.data() + (size_t)(g.atlasPos.y + row) * (size_t)page.size + (size_t)g.atlasPos.x,
+                        pixels + (ptrdiff_t)row * pitch, (size_t)g.size.x);
+        }
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch);
+        glBindTexture(GL_TEXTURE_2D, page.texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, g.atlasPos.x, g.atlasPos.y, g.size.x, g.size.y,
+                        GL_RED, GL_UNSIGNED_BYTE, pixels);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    m_glyphs[cp] = g;
+    return true;
+}
+
+// 在主线程栅格化单个位图字形并写入图集
+bool TextRenderer::loadGlyph(char32_t cp) {
+    if (!m_ftFace) return false;
+    FT_Face face = (FT_Face)m_ftFace;
+
+    if (FT_Load_Char(face, (FT_ULong)cp, FT_LOAD_RENDER)) {
+        return false;
+    }
 
+    const FT_Bitmap& bmp = face->glyph->bitmap;
     Glyph g;
-    g.texture = tex;
-    g.size = glm::ivec2((int)face->glyph->bitmap.width, (int)face->glyph->bitmap.rows);
+    g.size = glm::ivec2((int)bmp.width, (int)bmp.rows);
     g.bearing = glm::ivec2((int)face->glyph->bitmap_left, (int)face->glyph->bitmap_top);
     g.advance = (unsigned int)face->glyph->advance.x;
+    g.ascent = g.bearing.y;
+    g.descent = g.size.y - g.bearing.y;
+    return storeGlyph(cp, g, bmp.buffer, bmp.pitch);
+}
 
-    m_glyphs[cp] = g;
-    return true;
+// 加载一组尚未缓存的字形：距离场模式下交给工作线程并行生成
+void TextRenderer::loadGlyphs(const std::vector<char32_t>& cps) {
+    if (!m_sdf) {
+        for (auto cp : cps) loadGlyph(cp);
+        return;
+    }
+
+    m_rasterizer.rasterize(cps, m_rasterized);
+    for (size_t i = 0; i < cps.size(); ++i) {
+        RasterizedGlyph& r = m_rasterized[i];
+        if (!r.ok) continue;
+
+        Glyph g;
+        g.size = r.size;
+        g.bearing = r.bearing;
+        g.advance = r.advance;
+        g.ascent = r.ascent;
+        g.descent = r.descent;
+        storeGlyph(cps[i], g, r.pixels.data(), r.size.x);
+    }
 }
 
 // 预加载字符串所需字形
-void TextRenderer::preload(const std::string& utf8) {
+void TextRenderer::preload(std::string_view utf8) {
     auto cps = util::utf8ToCodepoints(utf8);
-    // 遍历字符并预加载字形
+    // 收集未缓存的字形（去重）后一次性加载
+    m_missing.clear();
     for (auto cp : cps) {
-        if (m_glyphs.find(cp) == m_glyphs.end()) {
-            loadGlyph(cp);
+        if (m_glyphs.find(cp) == m_glyphs.end() &&
+            std::find(m_missing.begin(), m_missing.end(), cp) == m_missing.end()) {
+            m_missing.push_back(cp);
         }
     }
+    if (!m_missing.empty()) loadGlyphs(m_missing);
 }
 
-// 计算文字显示尺寸
-TextMetrics TextRenderer::measureText(const std::string& utf8, float scale) {
-    TextMetrics m;
-    if (!m_ftFace) return m;
+// 从 LRU 链表中摘下槽位
+void TextRenderer::unlinkLayout(int32_t slot) {
+    TextLayout& e = m_layouts[(size_t)slot];
+    if (e.prev < 0 && m_lruHead != slot) return; // 不在链表中（新槽位）
+    if (e.prev >= 0) m_layouts[(size_t)e.prev].next = e.next;
+    else m_lruHead = e.next;
+    if (e.next >= 0) m_layouts[(size_t)e.next].prev = e.prev;
+    else m_lruTail = e.prev;
+    e.prev = e.next = -1;
+}
+
+// 把槽位移到链表头（最近使用）
+void TextRenderer::touchLayout(int32_t slot) {
+    if (m_lruHead == slot) return;
+    unlinkLayout(slot);
+    TextLayout& e = m_layouts[(size_t)slot];
+    e.next = m_lruHead;
+    if (m_lruHead >= 0) m_layouts[(size_t)m_lruHead].prev = slot;
+    m_lruHead = slot;
+    if (m_lruTail < 0) m_lruTail = slot;
+}
 
-    preload(utf8);
+// 解码并排版：生成相对基线起点的四边形并按图集页分段，同时求出尺寸
+void TextRenderer::buildLayout(TextLayout& entry) {
+    entry.vertices.clear();
+    entry.runs.clear();
+    entry.metrics = TextMetrics{};
+    if (!m_ftFace) return;
+
+    preload(entry.text);
+    auto cps = util::utf8ToCodepoints(entry.text);
+
+    const float scale = entry.scale;
+
+    // 按页收集，页数很少，逐页扫描即可保持同页四边形连续
+    for (size_t page = 0; page < m_pages.size(); ++page) {
+        uint32_t first = (uint32_t)entry.vertices.size();
+        float xCursor = 0.0f;
+        for (auto cp : cps) {
+            auto it = m_glyphs.find(cp);
+            if (it == m_glyphs.end()) continue;
+            const Glyph& ch = it->second;
+
+            if (ch.page == (int)page) {
+                float xpos = xCursor + (float)ch.bearing.x * scale;
+                float ypos = -(float)(ch.size.y - ch.bearing.y) * scale;
+                float w = (float)ch.size.x * scale;
+                float h = (float)ch.size.y * scale;
+
+                // 纹理坐标为图集像素，着色器按页尺寸归一化（页在批次中倍增也不失效）
+                float u0 = (float)ch.atlasPos.x;
+                float v0 = (float)ch.atlasPos.y;
+                float u1 = u0 + (float)ch.size.x;
+                float v1 = v0 + (float)ch.size.y;
+
+                glm::vec4 white(1.0f);
+                glm::vec4 none(0.0f);
+                entry.vertices.push_back({{xpos,     ypos + h}, {u0, v0}, white, none});
+                entry.vertices.push_back({{xpos,     ypos},     {u0, v1}, white, none});
+                entry.vertices.push_back({{xpos + w, ypos},     {u1, v1}, white, none});
+                entry.vertices.push_back({{xpos,     ypos + h}, {u0, v0}, white, none});
+                entry.vertices.push_back({{xpos + w, ypos},     {u1, v1}, white, none});
+                entry.vertices.push_back({{xpos + w, ypos + h}, {u1, v0}, white, none});
+            }
+            xCursor += (ch.advance / 64.0f) * scale;
+        }
+        uint32_t count = (uint32_t)entry.vertices.size() - first;
+        if (count > 0) entry.runs.push_back({(int)page, first, count});
+    }
 
     float width = 0.0f;
     float maxAscent = 0.0f;
     float maxDescent = 0.0f;
-
-    auto cps = util::utf8ToCodepoints(utf8);
     for (auto cp : cps) {
         auto it = m_glyphs.find(cp);
         if (it == m_glyphs.end()) continue;
         const Glyph& ch = it->second;
 
-        float ascent = (float)ch.bearing.y;
-        float descent = (float)ch.size.y - (float)ch.bearing.y;
+        float ascent = (float)ch.ascent;
+        float descent = (float)ch.descent;
         if (ascent > maxAscent) maxAscent = ascent;
         if (descent > maxDescent) maxDescent = descent;
 
         width += (ch.advance / 64.0f);
     }
 
-    m.width = width * scale;
-    m.ascent = maxAscent * scale;
-    m.descent = maxDescent * scale;
-    return m;
+    entry.metrics.width = width * scale;
+    entry.metrics.ascent = maxAscent * scale;
+    entry.metrics.descent = maxDescent * scale;
+}
+
+// 查找或生成排版；命中时不解码、不分配
+const TextLayout& TextRenderer::layout(std::string_view utf8, float scale) {
+    uint64_t hash = layoutHash(utf8, scale);
+    auto it = m_layoutIndex.find(hash);
+    if (it != m_layoutIndex.end()) {
+        TextLayout& e = m_layouts[(size_t)it->second];
+        if (e.scale == scale && e.text == utf8) {
+            touchLayout(it->second);
+            m_layoutStats.hits++;
+            return e;
+        }
+    }
+
+    // 未命中：哈希冲突时复用冲突槽位，否则新开槽位或淘汰最久未用者
+    int32_t slot;
+    if (it != m_layoutIndex.end()) {
+        slot = it->second;
+    } else if (m_layouts.size() < LAYOUT_CACHE_SIZE) {
+        slot = (int32_t)m_layouts.size();
+        m_layouts.emplace_back();
+        m_layoutIndex[hash] = slot;
+    } else {
+        slot = m_lruTail;
+        m_layoutIndex.erase(m_layouts[(size_t)slot].hash);
+        m_layoutIndex[hash] = slot;
+    }
+
+    TextLayout& e = m_layouts[(size_t)slot];
+    e.text.assign(utf8.data(), utf8.size());
+    e.scale = scale;
+    e.hash = hash;
+    buildLayout(e);
+    touchLayout(slot);
+    m_layoutStats.misses++;
+    return e;
+}
+
+// 计算文字显示尺寸
+TextMetrics TextRenderer::measureText(std::string_view utf8, float scale) {
+    if (!m_ftFace) return TextMetrics{};
+    return layout(utf8, scale).metrics;
+}
+
+// 立即绘制一段文字
+void TextRenderer::renderText(std::string_view utf8, float x, float y, float scale, const glm::vec3& color) {
+    appendText(utf8, x, y, scale, color);
+    flush();
 }
 
-// 逐字绘制文字到屏幕
-void TextRenderer::renderText(const std::string& utf8, float x, float y, float scale, const glm::vec3& color) {
+// 取缓存的排版，平移并着色后按图集页追加到当前批次
+void TextRenderer::appendText(std::string_view utf8, float x, float y, float scale, const glm::vec3& color,
+                              const TextEffect& effect) {
     if (!m_ftFace) return;
 
-    preload(utf8);
+    const TextLayout& l = layout(utf8, scale);
+    const glm::vec2 origin(x, y);
+    const glm::vec4 rgba(color, 1.0f);
+
+    // 效果换算到图集空间：屏幕偏移 (dx,dy) 对应向 (-dx,+dy)/scale 处采样（图集 v 轴向下）
+    glm::vec4 fx(0.0f);
+    if (m_sdf && scale > 0.0f) {
+        float maxOffset = (float)SDF_SPREAD;
+        fx.x = glm::clamp(-effect.shadowOffset.x / scale, -maxOffset, maxOffset);
+        fx.y = glm::clamp(effect.shadowOffset.y / scale, -maxOffset, maxOffset);
+        fx.z = effect.shadowAlpha;
+        fx.w = glm::clamp(effect.outline / scale / (2.0f * (float)SDF_SPREAD), 0.0f, 0.5f);
+    }
+
+    for (const auto& run : l.runs) {
+        auto& verts = m_pageVertices[(size_t)run.page];
+        for (uint32_t i = 0; i < run.count; ++i) {
+            const TextVertex& v = l.vertices[run.first + i];
+            verts.push_back({v.pos + origin, v.uv, rgba, fx});
+        }
+        m_pendingQuads += run.count / 6;
+    }
+}
+
+// 上传当前批次的全部顶点，每个图集页一次绘制
+void TextRenderer::flush() {
+    if (m_pendingQuads == 0) return;
+
+    m_upload.clear();
+    m_upload.reserve(m_pendingQuads * 6);
+    for (const auto& verts : m_pageVertices) {
+        m_upload.insert(m_upload.end(), verts.begin(), verts.end());
+    }
 
     // 开启混合以支持透明文字
     glEnable(GL_BLEND);
@@ -181,49 +504,26 @@ void TextRenderer::renderText(const std::string& utf8, float x, float y, float s
     m_shader.use();
     // 使用正交投影按像素绘制
     glm::mat4 proj = glm::ortho(0.0f, (float)m_w, 0.0f, (float)m_h);
-    m_shader.setMat4("projection", proj);
-    m_shader.setVec3("textColor", color);
-    m_shader.setInt("text", 0);
+    m_uProjection.set(proj);
+    m_uText.set(0);
+
+    uploadStreamBuffer(m_vbo, m_vboCapacity, m_upload.data(), m_upload.size() * sizeof(TextVertex));
 
     glActiveTexture(GL_TEXTURE0);
     glBindVertexArray(m_vao);
 
-    float xCursor = x;
-    auto cps = util::utf8ToCodepoints(utf8);
-
-    // 逐个字符生成四边形并绘制
-    for (auto cp : cps) {
-        auto it = m_glyphs.find(cp);
-        if (it == m_glyphs.end()) continue;
-        const Glyph& ch = it->second;
-
-        float xpos = xCursor + (float)ch.bearing.x * scale;
-        float ypos = y - (float)(ch.size.y - ch.bearing.y) * scale;
-
-        float w = (float)ch.size.x * scale;
-        float h = (float)ch.size.y * scale;
-
-        // 当前字符的屏幕四边形顶点
-        float vertices[6][4] = {
-            {xpos,     ypos + h,   0.0f, 0.0f},
-            {xpos,     ypos,       0.0f, 1.0f},
-            {xpos + w, ypos,       1.0f, 1.0f},
-
-            {xpos,     ypos + h,   0.0f, 0.0f},
-            {xpos + w, ypos,       1.0f, 1.0f},
-            {xpos + w, ypos + h,   1.0f, 0.0f},
-        };
-
-        glBindTexture(GL_TEXTURE_2D, ch.texture);
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-        // 更新游标位置
-        xCursor += (ch.advance / 64.0f) * scale;
+    GLint first = 0;
+    for (size_t i = 0; i < m_pageVertices.size(); ++i) {
+        auto& verts = m_pageVertices[i];
+        if (verts.empty()) continue;
+        glBindTexture(GL_TEXTURE_2D, m_pages[i].texture);
+        glDrawArrays(GL_TRIANGLES, first, (GLsizei)verts.size());
+        drawCounters().drawCalls++;
+        drawCounters().triangles += verts.size() / 3;
+        first += (GLint)verts.size();
+        verts.clear();
     }
+    m_pendingQuads = 0;
 
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -1,5 +1,7 @@
 #include "Texture.hpp"
+#include "TextureStreamer.hpp"
 #include "Util.hpp"
+#include "Vfs.hpp"
 
 #include <algorithm>
 
@@ -36,23 +38,46 @@ static GLuint uploadTexture(const unsigned char* pixels, int w, int h, int chann
 }
 
 Texture2D::~Texture2D() {
+    if (m_stream) m_stream->cancelled = true;
     if (m_id) glDeleteTextures(1, &m_id);
 }
 
 Texture2D::Texture2D(Texture2D&& other) noexcept {
     m_id = other.m_id;
+    m_width = other.m_width;
+    m_height = other.m_height;
+    m_stream = std::move(other.m_stream);
     other.m_id = 0;
 }
 
 Texture2D& Texture2D::operator=(Texture2D&& other) noexcept {
     if (this != &other) {
+        if (m_stream) m_stream->cancelled = true;
         if (m_id) glDeleteTextures(1, &m_id);
         m_id = other.m_id;
+        m_width = other.m_width;
+        m_height = other.m_height;
+        m_stream = std::move(other.m_stream);
         other.m_id = 0;
     }
     return *this;
 }
 
+bool Texture2D::resident() const {
+    return !m_stream || m_stream->resident;
+}
+
+// 异步纹理的尺寸由工作线程解码后写入
+int Texture2D::width() const {
+    if (!m_stream) return m_width;
+    return m_stream->decoded.load(std::memory_order_acquire) == 1 ? m_stream->width : 0;
+}
+
+int Texture2D::height() const {
+    if (!m_stream) return m_height;
+    return m_stream->decoded.load(std::memory_order_acquire) == 1 ? m_stream->height : 0;
+}
+
 // 从文件加载纹理
 Texture2D Texture2D::fromFile(const std::string& path, bool mip) {
     Texture2D t;
@@ -60,13 +85,16 @@ Texture2D Texture2D::fromFile(const std::string& path, bool mip) {
     stbi_set_flip_vertically_on_load(1);
 
     int w = 0, h = 0, c = 0;
-    unsigned char* data = stbi_load(path.c_str(), &w, &h, &c, 0);
+    vfs::File file = vfs::open(path);
+    unsigned char* data = file.valid() ? stbi_load_from_memory(file.data(), (int)file.size(), &w, &h, &c, 0) : nullptr;
     if (!data) {
         util::logWarn(std::string("Failed to load image: ") + path);
         return t;
     }
 
     t.m_id = uploadTexture(data, w, h, c, mip);
+    t.m_width = w;
+    t.m_height = h;
     stbi_image_free(data);
 
     if (t.m_id) util::logInfo(std::string("Loaded texture: ") + path);
@@ -86,6 +114,8 @@ Texture2D Texture2D::fromMemory(const unsigned char* data, int sizeBytes, bool m
     }
 
     t.m_id = uploadTexture(pixels, w, h, c, mip);
+    t.m_width = w;
+    t.m_height = h;
     stbi_image_free(pixels);
     return t;
 }
@@ -94,5 +124,117 @@ Texture2D Texture2D::fromMemory(const unsigned char* data, int sizeBytes, bool m
 Texture2D Texture2D::fromPixels(const unsigned char* pixels, int w, int h, int channels, bool mip) {
     Texture2D t;
     t.m_id = uploadTexture(pixels, w, h, channels, mip);
+    if (t.m_id) {
+        t.m_width = w;
+        t.m_height = h;
+    }
     return t;
 }
+
+// 解码为 RGBA 像素：翻转标志按线程设置，不影响其他线程的解码
+bool Texture2D::decodeRgba(const unsigned char* data, int sizeBytes, std::vector<unsigned char>& rgba, int& w, int& h) {
+    stbi_set_flip_vertically_on_load_thread(1);
+
+    int c = 0;
+    unsigned char* pixels = stbi_load_from_memory(data, sizeBytes, &w, &h, &c, 4);
+    if (!pixels) return false;
+
+    rgba.assign(pixels, pixels + (size_t)w * (size_t)h * 4);
+    stbi_image_free(pixels);
+    return true;
+}
+
+// 异步加载文件：先分配纹理名，像素在工作线程解码后分帧上传
+Texture2D Texture2D::fromFileAsync(TextureStreamer& streamer, const std::string& path, bool mip) {
+    if (!streamer.running()) return fromFile(path, mip);
+
+    Texture2D t;
+    glGenTextures(1, &t.m_id);
+    t.m_stream = streamer.enqueueFile(t.m_id, path, mip);
+    return t;
+}
+
+// 异步解码调用方已读入的压缩图片字节；label 用于日志
+Texture2D Texture2D::fromEncodedAsync(TextureStreamer& streamer, std::vector<unsigned char> bytes, const std::string& label, bool mip) {
+    if (!streamer.running()) return fromMemory(bytes.data(), (int)bytes.size(), mip);
+
+    Texture2D t;
+    glGenTextures(1, &t.m_id);
+    t.m_stream = streamer.enqueueEncoded(t.m_id, std::move(bytes), label, mip);
+    if (!t.m_stream) {
+        glDeleteTextures(1, &t.m_id);
+        t.m_id = 0;
+    }
+    return t;
+}
+
+// 异步上传已解码的 RGBA 像素
+Texture2D Texture2D::fromPixelsAsync(TextureStreamer& streamer, std::vector<unsigned char> rgba, int w, int h, bool mip) {
+    if (!streamer.running()) return fromPixels(rgba.data(), w, h, 4, mip);
+
+    Texture2D t;
+    glGenTextures(1, &t.m_id);
+    t.m_stream = streamer.enqueuePixels(t.m_id, std::move(rgba), w, h, mip);
+    if (!t.m_stream) {
+        glDeleteTextures(1, &t.m_id);
+        t.m_id = 0;
+    }
+    return t;
+}
+
+Texture2DArray::~Texture2DArray() {
+    if (m_id) glDeleteTextures(1, &m_id);
+}
+
+Texture2DArray::Texture2DArray(Texture2DArray&& other) noexcept {
+    *this = std::move(other);
+}
+
+Texture2DArray& Texture2DArray::operator=(Texture2DArray&& other) noexcept {
+    if (this != &other) {
+        if (m_id) glDeleteTextures(1, &m_id);
+        m_id = other.m_id;
+        m_width = other.m_width;
+        m_height = other.m_height;
+        m_layers = other.m_layers;
+        m_mip = other.m_mip;
+        other.m_id = 0;
+        other.m_layers = 0;
+    }
+    return *this;
+}
+
+// 分配纹理数组存储：各层在之后逐层上传
+Texture2DArray Texture2DArray::create(int w, int h, int layers, bool mip) {
+    Texture2DArray t;
+    if (w <= 0 || h <= 0 || layers <= 0) return t;
+
+    glGenTextures(1, &t.m_id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, t.m_id);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, mip ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, w, h, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    t.m_width = w;
+    t.m_height = h;
+    t.m_layers = layers;
+    t.m_mip = mip;
+    return t;
+}
+
+void Texture2DArray::uploadLayer(int layer, const unsigned char* rgba) {
+    if (!m_id || !rgba || layer < 0 || layer >= m_layers) return;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_id);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_width, m_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void Texture2DArray::generateMips() {
+    if (!m_id || !m_mip) return;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_id);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
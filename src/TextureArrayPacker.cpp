@@ -0,0 +1,98 @@
+#include "TextureArrayPacker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+// RGBA 双线性缩放（纹素中心对齐，边缘钳制）
+static std::vector<unsigned char> resizeRgba(const std::vector<unsigned char>& src, int sw, int sh, int dw, int dh) {
+    std::vector<unsigned char> dst((size_t)dw * (size_t)dh * 4);
+    const float sx = (float)sw / (float)dw;
+    const float sy = (float)sh / (float)dh;
+    for (int y = 0; y < dh; ++y) {
+        float fy = std::max(0.0f, ((float)y + 0.5f) * sy - 0.5f);
+        int y0 = std::min((int)fy, sh - 1);
+        int y1 = std::min(y0 + 1, sh - 1);
+        float ty = fy - (float)y0;
+        for (int x = 0; x < dw; ++x) {
+            float fx = std::max(0.0f, ((float)x + 0.5f) * sx - 0.5f);
+            int x0 = std::min((int)fx, sw - 1);
+            int x1 = std::min(x0 + 1, sw - 1);
+            float tx = fx - (float)x0;
+            const unsigned char* p00 = &src[((size_t)y0 * sw + x0) * 4];
+            const unsigned char* p10 = &src[((size_t)y0 * sw + x1) * 4];
+            const unsigned char* p01 = &src[((size_t)y1 * sw + x0) * 4];
+            const unsigned char* p11 = &src[((size_t)y1 * sw + x1) * 4];
+            unsigned char* out = &dst[((size_t)y * dw + x) * 4];
+            for (int c = 0; c < 4; ++c) {
+                float top = p00[c] + (p10[c] - p00[c]) * tx;
+                float bottom = p01[c] + (p11[c] - p01[c]) * tx;
+                out[c] = (unsigned char)std::lround(top + (bottom - top) * ty);
+            }
+        }
+    }
+    return dst;
+}
+
+void TextureArrayPacker::add(std::string key, std::vector<unsigned char> rgba, int w, int h, uint64_t hash) {
+    if (w <= 0 || h <= 0 || rgba.size() != (size_t)w * (size_t)h * 4) return;
+    Image img;
+    img.key = std::move(key);
+    img.width = w;
+    img.height = h;
+    img.hash = hash;
+    auto it = hash ? m_byHash.find(hash) : m_byHash.end();
+    if (it != m_byHash.end()) {
+        img.source = it->second;
+        m_duplicates++;
+    } else {
+        img.rgba = std::move(rgba);
+        if (hash) m_byHash.emplace(hash, (int)m_images.size());
+    }
+    m_images.push_back(std::move(img));
+}
+
+int TextureArrayPacker::pack(int maxLayers) {
+    m_layerW = m_layerH = m_layerCount = 0;
+    if (m_images.empty() || maxLayers <= 0) return 0;
+
+    std::map<std::pair<int, int>, int> sizes;
+    for (const auto& img : m_images) {
+        if (img.source < 0) sizes[{img.width, img.height}]++;
+    }
+    int best = 0;
+    for (const auto& [size, n] : sizes) {
+        const int64_t area = (int64_t)size.first * size.second;
+        if (n > best || (n == best && area > (int64_t)m_layerW * m_layerH)) {
+            best = n;
+            m_layerW = size.first;
+            m_layerH = size.second;
+        }
+    }
+
+    for (auto& img : m_images) {
+        img.layer = -1;
+        if (img.source >= 0) {
+            img.layer = m_images[img.source].layer; // 源图像总在副本之前
+            continue;
+        }
+        if (m_layerCount >= maxLayers) continue;
+        if ((int64_t)img.width * m_layerH != (int64_t)img.height * m_layerW) continue;
+        if (img.width != m_layerW || img.height != m_layerH) {
+            img.rgba = resizeRgba(img.rgba, img.width, img.height, m_layerW, m_layerH);
+            img.width = m_layerW;
+            img.height = m_layerH;
+        }
+        img.layer = m_layerCount++;
+    }
+    return m_layerCount;
+}
+
+void TextureArrayPacker::clear() {
+    m_images.clear();
+    m_byHash.clear();
+    m_duplicates = 0;
+    m_layerW = m_layerH = m_layerCount = 0;
+}
@@ -0,0 +1,298 @@
+#include "TextureStreamer.hpp"
+
+#include "Texture.hpp"
+#include "Util.hpp"
+#include "Vfs.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+TextureStreamer::~TextureStreamer() {
+    stopWorkers();
+}
+
+// 工作线程在做完手头的任务后退出；未开始的任务丢弃
+void TextureStreamer::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_threads) t.join();
+    m_threads.clear();
+    m_jobs.clear();
+}
+
+void TextureStreamer::shutdown() {
+    // 先等工作线程退出，之后不会再有写入已映射 PBO 的 memcpy
+    stopWorkers();
+
+    for (int i = 0; i < m_slotCount; ++i) {
+        Slot& slot = m_slots[i];
+        if (slot.mapped) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            slot.mapped = nullptr;
+        }
+        if (slot.fence) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (slot.pbo) glDeleteBuffers(1, &slot.pbo);
+        slot.pbo = 0;
+        slot.stream.reset();
+        slot.state = SlotState::Free;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    m_slots.reset();
+    m_slotCount = 0;
+
+    for (auto& s : m_streams) s->cancelled = true;
+    m_streams.clear();
+}
+
+bool TextureStreamer::init(size_t slotBytes, int slotCount, unsigned threadCount) {
+    if (running() || slotBytes == 0 || slotCount <= 0 || threadCount == 0) return false;
+
+    m_slotBytes = slotBytes;
+    m_slotCount = slotCount;
+    m_slots = std::make_unique<Slot[]>((size_t)slotCount);
+    for (int i = 0; i < slotCount; ++i) {
+        glGenBuffers(1, &m_slots[i].pbo);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_slots[i].pbo);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)slotBytes, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    m_stop = false;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&TextureStreamer::workerMain, this);
+    }
+    return true;
+}
+
+std::shared_ptr<TextureStream> TextureStreamer::enqueueFile(GLuint texture, const std::string& path, bool mip) {
+    if (!running()) return nullptr;
+    auto s = std::make_shared<TextureStream>();
+    s->texture = texture;
+    s->mip = mip;
+    s->path = path;
+    m_streams.push_back(s);
+    post(Job{s, nullptr});
+    return s;
+}
+
+std::shared_ptr<TextureStream> TextureStreamer::enqueueEncoded(GLuint texture, std::vector<unsigned char> bytes,
+                                                               const std::string& label, bool mip) {
+    if (!running() || bytes.empty()) return nullptr;
+    auto s = std::make_shared<TextureStream>();
+    s->texture = texture;
+    s->mip = mip;
+    s->path = label;
+    s->encoded = std::move(bytes);
+    m_streams.push_back(s);
+    post(Job{s, nullptr});
+    return s;
+}
+
+std::shared_ptr<TextureStream> TextureStreamer::enqueuePixels(GLuint texture, std::vector<unsigned char> rgba, int w, int h, bool mip) {
+    if (!running() || w <= 0 || h <= 0 || rgba.size() < (size_t)w * (size_t)h * 4) return nullptr;
+    auto s = std::make_shared<TextureStream>();
+    s->texture = texture;
+    s->mip = mip;
+    s->pixels = std::move(rgba);
+    s->width = w;
+    s->height = h;
+    s->decoded.store(1, std::memory_order_relaxed);
+    m_streams.push_back(s);
+    return s;
+}
+
+void TextureStreamer::post(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_wake.notify_one();
+}
+
+// 首个行带提交前分配纹理存储
+void TextureStreamer::allocate(TextureStream& s) {
+    glBindTexture(GL_TEXTURE_2D, s.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, s.mip ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, s.width, s.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    s.allocated = true;
+}
+
+// 全部行带已提交：生成多级渐远纹理并释放 CPU 端像素
+void TextureStreamer::finish(TextureStream& s) {
+    if (s.mip) {
+        glBindTexture(GL_TEXTURE_2D, s.texture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    s.resident = true;
+    std::vector<unsigned char>().swap(s.pixels);
+    if (!s.path.empty()) util::logInfo("Loaded texture: " + s.path + " (streamed)");
+}
+
+// 解除映射并从 PBO 提交一个行带；纹理已被销毁时直接回收
+void TextureStreamer::submitSlot(Slot& slot) {
+    TextureStream& s = *slot.stream;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    slot.mapped = nullptr;
+
+    if (s.cancelled) {
+        slot.state = SlotState::Free;
+        slot.stream.reset();
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, s.texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, slot.row0, s.width, slot.rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.state = SlotState::InFlight;
+
+    m_stats.uploadBytes += (uint32_t)((size_t)slot.rows * (size_t)s.width * 4);
+    m_stats.uploads++;
+    s.uploadedRows += slot.rows;
+    if (s.uploadedRows >= s.height) finish(s);
+}
+
+void TextureStreamer::update(size_t budgetBytes) {
+    m_stats = TextureStreamStats{};
+    if (!running()) return;
+
+    // 1) GPU 已读完的 PBO 回到空闲
+    for (int i = 0; i < m_slotCount; ++i) {
+        Slot& slot = m_slots[i];
+        if (slot.state != SlotState::InFlight) continue;
+        GLenum r = glClientWaitSync(slot.fence, 0, 0);
+        if (r != GL_ALREADY_SIGNALED && r != GL_CONDITION_SATISFIED) continue;
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        slot.stream.reset();
+        slot.state = SlotState::Free;
+    }
+
+    // 2) 提交已填好的行带，超出预算的留到下一帧（每帧至少提交一个）
+    for (int i = 0; i < m_slotCount; ++i) {
+        Slot& slot = m_slots[i];
+        if (slot.state != SlotState::Filling || !slot.filled.load(std::memory_order_acquire)) continue;
+        if (m_stats.uploadBytes > 0 && m_stats.uploadBytes >= budgetBytes) break;
+        submitSlot(slot);
+    }
+
+    // 3) 已解码的纹理按提交顺序领取空闲 PBO，映射后交给工作线程填充
+    int freeSlot = 0;
+    auto nextFree = [&]() -> Slot* {
+        for (; freeSlot < m_slotCount; ++freeSlot) {
+            if (m_slots[freeSlot].state == SlotState::Free) return &m_slots[freeSlot++];
+        }
+        return nullptr;
+    };
+    for (auto& sp : m_streams) {
+        TextureStream& s = *sp;
+        if (s.cancelled || s.resident) continue;
+        int d = s.decoded.load(std::memory_order_acquire);
+        if (d == 0) continue;
+        if (d < 0) {
+            util::logWarn("Failed to load image: " + s.path);
+            s.cancelled = true;
+            continue;
+        }
+        if (!s.allocated) allocate(s);
+
+        const size_t rowBytes = (size_t)s.width * 4;
+        if (rowBytes > m_slotBytes) {
+            // 单行放不进 PBO：直接从内存上传
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glBindTexture(GL_TEXTURE_2D, s.texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, s.width, s.height, GL_RGBA, GL_UNSIGNED_BYTE, s.pixels.data());
+            glBindTexture(GL_TEXTURE_2D, 0);
+            m_stats.uploadBytes += (uint32_t)(rowBytes * (size_t)s.height);
+            s.nextRow = s.uploadedRows = s.height;
+            finish(s);
+            continue;
+        }
+
+        const int bandRows = (int)(m_slotBytes / rowBytes);
+        while (s.nextRow < s.height) {
+            Slot* slot = nextFree();
+            if (!slot) break;
+            slot->stream = sp;
+            slot->row0 = s.nextRow;
+            slot->rows = std::min(bandRows, s.height - s.nextRow);
+            s.nextRow += slot->rows;
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot->pbo);
+            slot->mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)(rowBytes * (size_t)slot->rows),
+                                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            if (!slot->mapped) {
+                // 映射失败：本行带改为直接从内存上传
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                glBindTexture(GL_TEXTURE_2D, s.texture);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, slot->row0, s.width, slot->rows, GL_RGBA, GL_UNSIGNED_BYTE,
+                                s.pixels.data() + (size_t)slot->row0 * rowBytes);
+                glBindTexture(GL_TEXTURE_2D, 0);
+                m_stats.uploadBytes += (uint32_t)(rowBytes * (size_t)slot->rows);
+                s.uploadedRows += slot->rows;
+                slot->stream.reset();
+                if (s.uploadedRows >= s.height) finish(s);
+                continue;
+            }
+            slot->filled.store(false, std::memory_order_relaxed);
+            slot->state = SlotState::Filling;
+            post(Job{nullptr, slot});
+        }
+        if (freeSlot >= m_slotCount) break;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    m_streams.erase(std::remove_if(m_streams.begin(), m_streams.end(),
+        [](const std::shared_ptr<TextureStream>& s) { return s->resident || s->cancelled; }), m_streams.end());
+    m_stats.pending = (uint32_t)m_streams.size();
+}
+
+void TextureStreamer::workerMain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [&] { return m_stop || !m_jobs.empty(); });
+        if (m_stop) break;
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        lock.unlock();
+
+        if (job.slot) {
+            // 填充：把一个行带复制进已映射的 PBO
+            Slot& slot = *job.slot;
+            const TextureStream& s = *slot.stream;
+            const size_t rowBytes = (size_t)s.width * 4;
+            std::memcpy(slot.mapped, s.pixels.data() + (size_t)slot.row0 * rowBytes, rowBytes * (size_t)slot.rows);
+            slot.filled.store(true, std::memory_order_release);
+        } else {
+            // 解码：经 VFS 读文件（或取调用方给出的字节）并解为 RGBA
+            TextureStream& s = *job.stream;
+            std::vector<unsigned char> bytes = std::move(s.encoded);
+            vfs::File file;
+            const unsigned char* data = bytes.data();
+            size_t size = bytes.size();
+            if (bytes.empty()) {
+                file = vfs::open(s.path);
+                data = file.data();
+                size = file.size();
+            }
+            bool ok = size > 0 && Texture2D::decodeRgba(data, (int)size, s.pixels, s.width, s.height);
+            s.decoded.store(ok ? 1 : -1, std::memory_order_release);
+        }
+
+        lock.lock();
+    }
+}
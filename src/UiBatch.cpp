@@ -0,0 +1,86 @@
+#include "UiBatch.hpp"
+
+#include "RenderStats.hpp"
+#include "StreamBuffer.hpp"
+#include "Util.hpp"
+
+UiBatcher::~UiBatcher() {
+    if (m_vbo) glDeleteBuffers(1, &m_vbo);
+    if (m_vao) glDeleteVertexArrays(1, &m_vao);
+    m_vbo = m_vao = 0;
+}
+
+// 编译界面程序并创建流式顶点缓冲
+bool UiBatcher::init() {
+    try {
+        m_shader = Shader("assets/shaders/ui.vert", "assets/shaders/ui.frag");
+    } catch (const std::exception& e) {
+        util::logError(e.what());
+        return false;
+    }
+    m_shader.use();
+    m_shader.uniform<int>("uiTexture").set(0);
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    m_vboCapacity = sizeof(UiVertex) * 6 * 64;
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m_vboCapacity, nullptr, GL_STREAM_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, posUV));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, color));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(UiVertex), (void*)offsetof(UiVertex, mode));
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    m_vertices.reserve(6 * 64);
+    return true;
+}
+
+// 追加一个矩形；与当前批次纹理冲突时先绘制已有内容
+void UiBatcher::addRect(const UiRect& r, const glm::vec4& color, GLuint tex, bool texAlpha) {
+    if (tex && tex != m_texture) {
+        if (m_texture) flush();
+        m_texture = tex;
+    }
+
+    glm::vec2 mode(tex ? 1.0f : 0.0f, (tex && texAlpha) ? 1.0f : 0.0f);
+    float x0 = r.x, y0 = r.y, x1 = r.x + r.w, y1 = r.y + r.h;
+    m_vertices.push_back({{x0, y0, 0.0f, 0.0f}, color, mode});
+    m_vertices.push_back({{x1, y0, 1.0f, 0.0f}, color, mode});
+    m_vertices.push_back({{x1, y1, 1.0f, 1.0f}, color, mode});
+    m_vertices.push_back({{x0, y0, 0.0f, 0.0f}, color, mode});
+    m_vertices.push_back({{x1, y1, 1.0f, 1.0f}, color, mode});
+    m_vertices.push_back({{x0, y1, 0.0f, 1.0f}, color, mode});
+    m_stats.quads++;
+}
+
+// 一次上传当前批次并绘制
+void UiBatcher::flush() {
+    if (m_vertices.empty()) {
+        m_texture = 0;
+        return;
+    }
+
+    uploadStreamBuffer(m_vbo, m_vboCapacity, m_vertices.data(), m_vertices.size() * sizeof(UiVertex));
+
+    m_shader.use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)m_vertices.size());
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    drawCounters().drawCalls++;
+    drawCounters().triangles += m_vertices.size() / 3;
+    m_stats.batches++;
+
+    m_vertices.clear();
+    m_texture = 0;
+}
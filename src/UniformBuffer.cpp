@@ -0,0 +1,71 @@
+#include "UniformBuffer.hpp"
+
+#include <utility>
+
+int uniformBlockBinding(const std::string& blockName) {
+    if (blockName == "FrameData") return (int)UBO_BINDING_FRAME;
+    if (blockName == "MaterialData") return (int)UBO_BINDING_MATERIAL;
+    return -1;
+}
+
+UniformBuffer::~UniformBuffer() {
+    if (m_id) glDeleteBuffers(1, &m_id);
+}
+
+UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) noexcept {
+    if (this != &other) {
+        if (m_id) glDeleteBuffers(1, &m_id);
+        m_id = other.m_id;
+        m_size = other.m_size;
+        m_usage = other.m_usage;
+        other.m_id = 0;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+// 分配缓冲存储
+UniformBuffer UniformBuffer::create(size_t size, const void* data, GLenum usage) {
+    UniformBuffer ub;
+    ub.m_size = size;
+    ub.m_usage = usage;
+    glGenBuffers(1, &ub.m_id);
+    glBindBuffer(GL_UNIFORM_BUFFER, ub.m_id);
+    glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)size, data, usage);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    return ub;
+}
+
+// 孤立后重新写入
+void UniformBuffer::update(const void* data, size_t size) {
+    if (!m_id) return;
+    if (size > m_size) m_size = size;
+    glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+    glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)m_size, nullptr, m_usage);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::bindRange(GLuint binding, size_t offset, size_t size) const {
+    if (!m_id) return;
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_id, (GLintptr)offset, (GLsizeiptr)size);
+}
+
+size_t UniformBuffer::offsetAlignment() {
+    static size_t alignment = 0;
+    if (alignment == 0) {
+        GLint a = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &a);
+        alignment = (a > 0) ? (size_t)a : 256;
+    }
+    return alignment;
+}
+
+size_t UniformBuffer::alignOffset(size_t n) {
+    size_t a = offsetAlignment();
+    return (n + a - 1) / a * a;
+}
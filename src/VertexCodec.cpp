@@ -0,0 +1,61 @@
+#include "VertexCodec.hpp"
+
+#include <glm/gtc/packing.hpp>
+#include <glm/packing.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace vertexcodec {
+
+void pack(const VertexPN* in, size_t count, VertexPacked* out, VertexDequant& dequant, PackError& err) {
+    err = PackError{};
+    glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+    for (size_t i = 0; i < count; ++i) {
+        lo = glm::min(lo, in[i].pos);
+        hi = glm::max(hi, in[i].pos);
+    }
+    if (count == 0) lo = hi = glm::vec3(0.0f);
+
+    dequant.offset = lo;
+    dequant.scale = hi - lo;
+    const float extent = std::max(dequant.scale.x, std::max(dequant.scale.y, dequant.scale.z));
+
+    for (size_t i = 0; i < count; ++i) {
+        const VertexPN& v = in[i];
+        VertexPacked& p = out[i];
+        for (int a = 0; a < 3; ++a) {
+            float t = dequant.scale[a] > 0.0f ? (v.pos[a] - lo[a]) / dequant.scale[a] : 0.0f;
+            p.pos[a] = (uint16_t)std::lround(glm::clamp(t, 0.0f, 1.0f) * 65535.0f);
+        }
+        p.pos[3] = 0;
+        p.normal = glm::packSnorm3x10_1x2(glm::vec4(glm::clamp(v.normal, -1.0f, 1.0f), 0.0f));
+        p.uv = glm::packHalf2x16(v.uv);
+
+        // 往返误差
+        VertexPN r = unpack(p, dequant);
+        glm::vec3 dp = glm::abs(r.pos - v.pos);
+        if (extent > 0.0f) err.pos = std::max(err.pos, std::max(dp.x, std::max(dp.y, dp.z)) / extent);
+
+        float ln = glm::length(r.normal), lv = glm::length(v.normal);
+        if (ln > 0.0f && lv > 0.0f) {
+            float c = glm::clamp(glm::dot(r.normal, v.normal) / (ln * lv), -1.0f, 1.0f);
+            err.normalDeg = std::max(err.normalDeg, glm::degrees(std::acos(c)));
+        }
+
+        glm::vec2 du = glm::abs(r.uv - v.uv);
+        err.uv = std::max(err.uv, std::max(du.x, du.y));
+    }
+}
+
+VertexPN unpack(const VertexPacked& v, const VertexDequant& dequant) {
+    VertexPN r;
+    glm::vec3 q(v.pos[0], v.pos[1], v.pos[2]);
+    r.pos = dequant.offset + (q / 65535.0f) * dequant.scale;
+    r.normal = glm::vec3(glm::unpackSnorm3x10_1x2(v.normal));
+    r.uv = glm::unpackHalf2x16(v.uv);
+    return r;
+}
+
+} // namespace vertexcodec
@@ -0,0 +1,152 @@
+#include "Vfs.hpp"
+
+#include "AssetPack.hpp"
+#include "Lz4.hpp"
+#include "Util.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace vfs {
+
+namespace {
+
+assetpack::AssetPack g_pack;
+
+bool isAssetPath(std::string_view path) {
+    return path.substr(0, 7) == "assets/";
+}
+
+// 该路径在资源包中找不到时能否读磁盘
+bool diskAllowed(std::string_view path) {
+#ifdef XIANGQI3D_LOOSE_ASSETS
+    (void)path;
+    return true;
+#else
+    return !isAssetPath(path);
+#endif
+}
+
+const assetpack::PackEntry* findPacked(const std::string& path) {
+    return g_pack.valid() ? g_pack.find(path) : nullptr;
+}
+
+} // namespace
+
+bool mount(const std::string& packPath) {
+    unmount();
+    if (!g_pack.open(packPath)) return false;
+    util::logInfo("Mounted asset pack: " + packPath + " (" + std::to_string(g_pack.count()) + " files, " +
+                  std::to_string(g_pack.bytes() / 1024) + " KB)");
+    return true;
+}
+
+void unmount() {
+    g_pack.close();
+}
+
+bool mounted() {
+    return g_pack.valid();
+}
+
+std::string normalize(std::string_view path) {
+    std::vector<std::string_view> parts;
+    std::string unified(path);
+    for (char& c : unified) {
+        if (c == '\\') c = '/';
+    }
+    const bool absolute = !unified.empty() && unified[0] == '/';
+    std::string_view rest(unified);
+    while (!rest.empty()) {
+        size_t slash = rest.find('/');
+        std::string_view part = rest.substr(0, slash);
+        rest = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+        if (part.empty() || part == ".") continue;
+        if (part == ".." && !parts.empty() && parts.back() != "..") {
+            parts.pop_back();
+            continue;
+        }
+        parts.push_back(part);
+    }
+    std::string out = absolute ? "/" : "";
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (i) out += '/';
+        out += parts[i];
+    }
+    return out;
+}
+
+bool exists(const std::string& path) {
+    const std::string key = normalize(path);
+    if (findPacked(key)) return true;
+    if (!diskAllowed(key)) return false;
+    std::error_code ec;
+    return fs::is_regular_file(path, ec);
+}
+
+bool stat(const std::string& path, Stat& out) {
+    const std::string key = normalize(path);
+    if (const auto* e = findPacked(key)) {
+        out.size = e->size;
+        out.mtime = e->mtime;
+        return true;
+    }
+    if (!diskAllowed(key)) return false;
+    std::error_code ec;
+    uintmax_t size = fs::file_size(path, ec);
+    if (ec) return false;
+    auto time = fs::last_write_time(path, ec);
+    if (ec) return false;
+    out.size = (uint64_t)size;
+    out.mtime = (int64_t)time.time_since_epoch().count();
+    return true;
+}
+
+File open(const std::string& path) {
+    File f;
+    const std::string key = normalize(path);
+    if (const auto* e = findPacked(key)) {
+        if (e->size == 0) return f;
+        if (!(e->flags & assetpack::ENTRY_LZ4)) {
+            f.m_data = g_pack.blob(*e);
+            f.m_size = (size_t)e->size;
+            return f;
+        }
+        auto buf = std::make_shared<std::vector<unsigned char>>((size_t)e->size);
+        if (!lz4::decompress(g_pack.blob(*e), (size_t)e->storedSize, buf->data(), buf->size())) {
+            util::logWarn("Corrupt asset pack entry: " + key);
+            return f;
+        }
+        f.m_data = buf->data();
+        f.m_size = buf->size();
+        f.m_owned = std::move(buf);
+        return f;
+    }
+    if (!diskAllowed(key)) return f;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return f;
+    auto buf = std::make_shared<std::vector<unsigned char>>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (buf->empty()) return f;
+    f.m_data = buf->data();
+    f.m_size = buf->size();
+    f.m_owned = std::move(buf);
+    return f;
+}
+
+std::string readText(const std::string& path) {
+    File f = open(path);
+    if (!f.valid()) {
+        // 空文件也是合法的文本
+        Stat st;
+        if (stat(path, st) && st.size == 0) return std::string();
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    return std::string(f.text());
+}
+
+} // namespace vfs
@@ -18,9 +18,9 @@ void XiangqiGame::reset() {
     m_sideToMove = Side::Red;
     m_status = GameStatus::Ongoing;
     m_selected.reset();
-    m_legalTargets.clear();
     m_captures.clear();
     m_moves.clear();
+    rebuildLegalCache();
 
     m_eventText.clear();
     m_eventTimer = 0.0f;
@@ -34,13 +34,24 @@ bool XiangqiGame::inCheck(Side s) const {
     return xiangqi::isInCheck(m_board, s);
 }
 
-// 计算选中棋子的合法落点
-void XiangqiGame::computeLegalTargets() {
-    m_legalTargets.clear();
-    if (!m_selected) return;
-    auto ms = xiangqi::legalMovesFrom(m_board, *m_selected, m_sideToMove);
-    m_legalTargets.reserve(ms.size());
-    for (const auto& m : ms) m_legalTargets.push_back(m.to);
+// 为当前走子方生成一次全部合法走法，并按起点格分组缓存
+void XiangqiGame::rebuildLegalCache() {
+    for (auto& row : m_legalByFrom) {
+        for (auto& targets : row) targets.clear();
+    }
+
+    auto ms = xiangqi::allLegalMoves(m_board, m_sideToMove);
+    for (const auto& m : ms) {
+        m_legalByFrom[m.from.y][m.from.x].push_back(m.to);
+    }
+    m_legalMoveCount = ms.size();
+}
+
+// 选中棋子的合法落点
+const std::vector<Pos>& XiangqiGame::legalTargets() const {
+    static const std::vector<Pos> kEmpty;
+    if (!m_selected) return kEmpty;
+    return m_legalByFrom[m_selected->y][m_selected->x];
 }
 
 // 处理棋盘点击交互
@@ -56,7 +67,6 @@ bool XiangqiGame::clickAt(const Pos& p) {
     if (!m_selected) {
         if (cell && cell->side == m_sideToMove) {
             m_selected = p;
-            computeLegalTargets();
             return true;
         }
         return false;
@@ -65,19 +75,18 @@ bool XiangqiGame::clickAt(const Pos& p) {
     // 点击同一格：取消选中
     if (*m_selected == p) {
         m_selected.reset();
-        m_legalTargets.clear();
         return true;
     }
 
     // 点击己方棋子：切换选中
     if (cell && cell->side == m_sideToMove) {
         m_selected = p;
-        computeLegalTargets();
         return true;
     }
 
     // 目标合法则尝试走子
-    bool isLegalTarget = std::any_of(m_legalTargets.begin(), m_legalTargets.end(), [&](const Pos& t) {
+    const auto& targets = legalTargets();
+    bool isLegalTarget = std::any_of(targets.begin(), targets.end(), [&](const Pos& t) {
         return t == p;
     });
     if (!isLegalTarget) {
@@ -98,7 +107,6 @@ bool XiangqiGame::clickAt(const Pos& p) {
 
     // 结束选中并切换回合
     m_selected.reset();
-    m_legalTargets.clear();
 
     m_sideToMove = other(m_sideToMove);
     afterMove();
@@ -110,8 +118,9 @@ void XiangqiGame::afterMove() {
     // 切换走子方后进行判定：
     // 1) 将死/困毙（走子方无合法走法即失败）
     // 2) 将军
+    // 新局面只生成一次合法走法，选中与判负都读取该缓存
+    rebuildLegalCache();
     const bool stmInCheck = xiangqi::isInCheck(m_board, m_sideToMove);
-    auto ms = xiangqi::allLegalMoves(m_board, m_sideToMove);
 
     auto setEvent = [&](std::string text, float seconds) {
         // 避免相同提示重复刷屏
@@ -124,7 +133,7 @@ void XiangqiGame::afterMove() {
         m_eventTimer = seconds;
     };
 
-    if (ms.empty()) {
+    if (m_legalMoveCount == 0) {
         // 象棋中，“无合法走法”即判负（无论是否被将军）
         Side winner = (m_sideToMove == Side::Red) ? Side::Black : Side::Red;
         m_status = (winner == Side::Red) ? GameStatus::RedWin : GameStatus::BlackWin;
@@ -5,13 +5,19 @@
 #include "Camera.hpp"
 #include "Config.hpp"
 #include "Renderer.hpp"
+#include "Replay.hpp"
 #include "Util.hpp"
+#include "Vfs.hpp"
 #include "XiangqiGame.hpp"
 #include "XiangqiRules.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <string>
+#include <thread>
 
 
 // 输入状态：记录鼠标拖拽与位置
@@ -19,6 +25,8 @@ struct InputState {
     bool rmbDown = false;
     double lastX = 0.0;
     double lastY = 0.0;
+    double mouseX = 0.0;
+    double mouseY = 0.0;
 };
 
 // 结算提示框布局
@@ -40,6 +48,8 @@ struct App {
     GLFWwindow* window = nullptr;
     int w = 1280;
     int h = 720;
+    int shadowSize = cfg::SHADOW_MAP_SIZE;
+    ShadowKernel shadowKernel = defaultShadowKernel();
 
     OrbitCamera cam;
     Renderer renderer;
@@ -154,140 +164,351 @@ static void framebufferSizeCallback(GLFWwindow* window, int w, int h) {
 }
 
 // 右键拖拽时旋转相机
-static void cursorPosCallback(GLFWwindow* window, double x, double y) {
-    auto* app = (App*)glfwGetWindowUserPointer(window);
-    if (!app) return;
-    if (app->mode != AppMode::Playing) return;
+static void handleCursorPos(App& app, double x, double y) {
+    app.input.mouseX = x;
+    app.input.mouseY = y;
+    if (app.mode != AppMode::Playing) return;
 
-    if (app->input.rmbDown) {
-        double dx = x - app->input.lastX;
-        double dy = y - app->input.lastY;
+    if (app.input.rmbDown) {
+        double dx = x - app.input.lastX;
+        double dy = y - app.input.lastY;
 
-        app->cam.yawDeg += (float)dx * 0.25f;
-        app->cam.pitchDeg += (float)dy * 0.25f;
-        app->cam.pitchDeg = clampf(app->cam.pitchDeg, 15.0f, 85.0f);
+        app.cam.yawDeg += (float)dx * 0.25f;
+        app.cam.pitchDeg += (float)dy * 0.25f;
+        app.cam.pitchDeg = clampf(app.cam.pitchDeg, 15.0f, 85.0f);
 
-        app->input.lastX = x;
-        app->input.lastY = y;
+        app.input.lastX = x;
+        app.input.lastY = y;
     }
 }
 
-// 鼠标按钮交互：菜单与棋盘点击
-static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
-    (void)mods;
-    auto* app = (App*)glfwGetWindowUserPointer(window);
-    if (!app) return;
-
+// 鼠标按钮交互：菜单与棋盘点击（坐标取最近一次光标位置）
+static void handleMouseButton(App& app, int button, int action) {
     if (button == GLFW_MOUSE_BUTTON_RIGHT) {
         if (action == GLFW_PRESS) {
-            app->input.rmbDown = true;
-            glfwGetCursorPos(window, &app->input.lastX, &app->input.lastY);
+            app.input.rmbDown = true;
+            app.input.lastX = app.input.mouseX;
+            app.input.lastY = app.input.mouseY;
         } else if (action == GLFW_RELEASE) {
-            app->input.rmbDown = false;
+            app.input.rmbDown = false;
         }
         return;
     }
 
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-        double mx = 0.0, my = 0.0;
-        glfwGetCursorPos(window, &mx, &my);
+        double mx = app.input.mouseX;
+        double my = app.input.mouseY;
 
-        if (app->mode == AppMode::Menu) {
-            MenuLayout layout = makeMenuLayout(app->w, app->h);
+        if (app.mode == AppMode::Menu) {
+            MenuLayout layout = makeMenuLayout(app.w, app.h);
             float sx = (float)mx;
-            float sy = (float)app->h - (float)my;
+            float sy = (float)app.h - (float)my;
             if (pointInRect(sx, sy, layout.start)) {
-                if (app->renderer.isPreloadReady()) {
-                    app->game.reset();
-                    app->mode = AppMode::Playing;
-                    if (!app->helpShown) {
-                        app->game.startHelp(6.0f);
-                        app->helpShown = true;
+                if (app.renderer.isPreloadReady()) {
+                    app.game.reset();
+                    app.mode = AppMode::Playing;
+                    if (!app.helpShown) {
+                        app.game.startHelp(6.0f);
+                        app.helpShown = true;
                     }
                 } else {
-                    app->mode = AppMode::Loading;
+                    app.mode = AppMode::Loading;
                 }
             } else if (pointInRect(sx, sy, layout.exit)) {
-                glfwSetWindowShouldClose(window, GLFW_TRUE);
+                glfwSetWindowShouldClose(app.window, GLFW_TRUE);
             }
             return;
         }
 
-        if (app->mode == AppMode::Loading) {
+        if (app.mode == AppMode::Loading) {
             return;
         }
 
-        if (app->mode == AppMode::Playing && app->game.resultPromptActive()) {
-            PromptLayout layout = makePromptLayout(app->w, app->h);
+        if (app.mode == AppMode::Playing && app.game.resultPromptActive()) {
+            PromptLayout layout = makePromptLayout(app.w, app.h);
             float sx = (float)mx;
-            float sy = (float)app->h - (float)my;
+            float sy = (float)app.h - (float)my;
             if (pointInRect(sx, sy, layout.restart)) {
-                app->game.reset();
+                app.game.reset();
             } else if (pointInRect(sx, sy, layout.exit)) {
-                glfwSetWindowShouldClose(window, GLFW_TRUE);
+                glfwSetWindowShouldClose(app.window, GLFW_TRUE);
             }
             return;
         }
 
         Pos p;
-        if (pickBoardPos(app->cam, mx, my, app->w, app->h, p)) {
-            app->game.clickAt(p);
+        if (pickBoardPos(app.cam, mx, my, app.w, app.h, p)) {
+            app.game.clickAt(p);
         }
         return;
     }
 }
 
 // 滚轮缩放相机距离
-static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
-    (void)xoffset;
-    auto* app = (App*)glfwGetWindowUserPointer(window);
-    if (!app) return;
-    if (app->mode != AppMode::Playing) return;
+static void handleScroll(App& app, double yoffset) {
+    if (app.mode != AppMode::Playing) return;
 
-    app->cam.distance -= (float)yoffset * 0.8f;
-    app->cam.distance = clampf(app->cam.distance, 6.0f, 30.0f);
+    app.cam.distance -= (float)yoffset * 0.8f;
+    app.cam.distance = clampf(app.cam.distance, 6.0f, 30.0f);
 }
 
 // 键盘快捷键处理
-static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-    (void)scancode;
-    (void)mods;
-    auto* app = (App*)glfwGetWindowUserPointer(window);
-    if (!app) return;
-
+static void handleKey(App& app, int key, int action) {
     if (action == GLFW_PRESS) {
-        if (app->mode == AppMode::Menu) {
+        if (app.mode == AppMode::Menu) {
             if (key == GLFW_KEY_ENTER || key == GLFW_KEY_KP_ENTER) {
-                if (app->renderer.isPreloadReady()) {
-                    app->game.reset();
-                    app->mode = AppMode::Playing;
-                    if (!app->helpShown) {
-                        app->game.startHelp(6.0f);
-                        app->helpShown = true;
+                if (app.renderer.isPreloadReady()) {
+                    app.game.reset();
+                    app.mode = AppMode::Playing;
+                    if (!app.helpShown) {
+                        app.game.startHelp(6.0f);
+                        app.helpShown = true;
                     }
                 } else {
-                    app->mode = AppMode::Loading;
+                    app.mode = AppMode::Loading;
                 }
                 return;
             }
             if (key == GLFW_KEY_ESCAPE) {
-                glfwSetWindowShouldClose(window, GLFW_TRUE);
+                glfwSetWindowShouldClose(app.window, GLFW_TRUE);
                 return;
             }
         }
         if (key == GLFW_KEY_ESCAPE) {
-            glfwSetWindowShouldClose(window, GLFW_TRUE);
+            glfwSetWindowShouldClose(app.window, GLFW_TRUE);
         }
         if (key == GLFW_KEY_R) {
-            app->game.reset();
+            app.game.reset();
+        }
+    }
+}
+
+static void cursorPosCallback(GLFWwindow* window, double x, double y) {
+    auto* app = (App*)glfwGetWindowUserPointer(window);
+    if (!app) return;
+    handleCursorPos(*app, x, y);
+}
+
+static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    (void)mods;
+    auto* app = (App*)glfwGetWindowUserPointer(window);
+    if (!app) return;
+    glfwGetCursorPos(window, &app->input.mouseX, &app->input.mouseY);
+    handleMouseButton(*app, button, action);
+}
+
+static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
+    (void)xoffset;
+    auto* app = (App*)glfwGetWindowUserPointer(window);
+    if (!app) return;
+    handleScroll(*app, yoffset);
+}
+
+static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    (void)scancode;
+    (void)mods;
+    auto* app = (App*)glfwGetWindowUserPointer(window);
+    if (!app) return;
+    handleKey(*app, key, action);
+}
+
+// 将回放事件派发给与窗口回调相同的处理函数
+static void dispatchReplayEvent(App& app, const ReplayEvent& e) {
+    switch (e.type) {
+        case ReplayEventType::MouseMove: handleCursorPos(app, e.x, e.y); break;
+        case ReplayEventType::MouseDown: handleMouseButton(app, e.code, GLFW_PRESS); break;
+        case ReplayEventType::MouseUp: handleMouseButton(app, e.code, GLFW_RELEASE); break;
+        case ReplayEventType::Scroll: handleScroll(app, e.y); break;
+        case ReplayEventType::Key:
+            handleKey(app, e.code, GLFW_PRESS);
+            handleKey(app, e.code, GLFW_RELEASE);
+            break;
+        case ReplayEventType::Camera:
+            app.cam.yawDeg = (float)e.x;
+            app.cam.pitchDeg = clampf((float)e.y, 15.0f, 85.0f);
+            app.cam.distance = clampf((float)e.z, 6.0f, 30.0f);
+            break;
+        case ReplayEventType::End: break;
+    }
+}
+
+// 单帧：更新逻辑并按模式渲染
+static void updateFrame(App& app, float dt) {
+    if (app.mode == AppMode::Playing) {
+        app.game.update(dt);
+    }
+}
+
+static void renderFrame(App& app) {
+    updateWindowTitle(app.window, app.game, app.mode);
+    if (app.mode == AppMode::Menu) {
+        MenuLayout layout = makeMenuLayout(app.w, app.h);
+        float sx = (float)app.input.mouseX;
+        float sy = (float)app.h - (float)app.input.mouseY;
+        bool hoverStart = pointInRect(sx, sy, layout.start);
+        bool hoverExit = pointInRect(sx, sy, layout.exit);
+        app.renderer.drawMenu(layout, hoverStart, hoverExit, true);
+    } else if (app.mode == AppMode::Loading) {
+        app.renderer.drawLoading(u8"\u6b63\u5728\u52a0\u8f7d\u8d44\u6e90\u002e\u002e\u002e\u002e\u002e\u002e");
+    } else {
+        app.renderer.draw(app.cam, app.game);
+    }
+}
+
+// 帧末推进资源预加载（在预算内上传工作线程已就绪的模型与纹理）
+static void advancePreload(App& app) {
+    app.renderer.streamTextures();
+    if (!app.renderer.isPreloadReady()) {
+        app.renderer.preloadStep();
+    } else if (app.mode == AppMode::Loading) {
+        app.game.reset();
+        app.mode = AppMode::Playing;
+        if (!app.helpShown) {
+            app.game.startHelp(6.0f);
+            app.helpShown = true;
+        }
+    }
+}
+
+// 回放/基准参数
+struct ReplayOptions {
+    std::string scriptPath;
+    std::string csvPath;
+    float dt = 1.0f / 60.0f;
+    int maxFrames = 0;       // 0 表示跑到脚本结束
+    bool offscreen = false;  // 使用无窗口平台 + OSMesa 软件上下文
+};
+
+// 解析命令行：--replay <脚本> [--dt 秒] [--frames N] [--csv 路径] [--size WxH] [--offscreen]
+//             [--shadow-size N] [--shadow-kernel pcf1|pcf4|pcf9|pcf16|poisson]
+static bool parseArgs(int argc, char** argv, App& app, ReplayOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto value = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--replay" && (v = value())) {
+            opt.scriptPath = v;
+        } else if (a == "--dt" && (v = value())) {
+            opt.dt = std::max(1e-4f, (float)std::atof(v));
+        } else if (a == "--frames" && (v = value())) {
+            opt.maxFrames = std::max(0, std::atoi(v));
+        } else if (a == "--csv" && (v = value())) {
+            opt.csvPath = v;
+        } else if (a == "--size" && (v = value())) {
+            int w = 0, h = 0;
+            if (std::sscanf(v, "%dx%d", &w, &h) == 2 && w > 0 && h > 0) {
+                app.w = w;
+                app.h = h;
+            }
+        } else if (a == "--offscreen") {
+            opt.offscreen = true;
+        } else if (a == "--shadow-size" && (v = value())) {
+            app.shadowSize = std::atoi(v);
+        } else if (a == "--shadow-kernel" && (v = value())) {
+            if (!parseShadowKernel(v, app.shadowKernel)) {
+                util::logError(std::string("Unknown shadow kernel: ") + v);
+                return false;
+            }
+        } else {
+            util::logError("Unknown or incomplete argument: " + a);
+            return false;
+        }
+    }
+    return true;
+}
+
+// 回放主循环：固定步长推进，逐帧记录 CPU 耗时
+static void runReplay(App& app, ReplayScript& script, const ReplayOptions& opt) {
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    // 脚本时钟开始前同步完成预加载（模型、流式纹理、纹理数组各层），
+    // 进入 Playing 的帧号因此与机器快慢、模型缓存冷热无关，加载帧也不进入帧统计
+    auto preloadStart = Clock::now();
+    while (!app.renderer.isPreloadReady() && !app.renderer.preloadFailed()) {
+        app.renderer.preloadStep();
+        app.renderer.streamTextures();
+        glFlush(); // 让流式纹理的栅栏得以完成
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    app.renderer.streamTextures();
+    if (app.renderer.preloadFailed()) util::logWarn("Replay: asset preload failed");
+    util::logInfo("Replay preload finished in " + std::to_string(ms(Clock::now() - preloadStart)) + " ms");
+
+    FrameStats stats;
+    double simTime = 0.0;
+    int frame = 0;
+    auto wallStart = Clock::now();
+
+    while (!glfwWindowShouldClose(app.window)) {
+        if (opt.maxFrames > 0 && frame >= opt.maxFrames) break;
+        if (opt.maxFrames == 0 && script.finished()) break;
+
+        while (const ReplayEvent* e = script.next(simTime)) {
+            dispatchReplayEvent(app, *e);
         }
+
+        auto t0 = Clock::now();
+        updateFrame(app, opt.dt);
+        auto t1 = Clock::now();
+        renderFrame(app);
+        // 软件光栅化下 GPU 工作也在 CPU 上，等待完成以计入整帧成本
+        glFinish();
+        auto t2 = Clock::now();
+
+        glfwSwapBuffers(app.window);
+        glfwPollEvents();
+        advancePreload(app);
+
+        FrameTiming ft;
+        ft.simTime = simTime;
+        ft.updateMs = ms(t1 - t0);
+        ft.renderMs = ms(t2 - t1);
+        ft.totalMs = ms(t2 - t0);
+        ft.render = app.renderer.stats();
+        if (app.mode != AppMode::Loading) stats.record(ft);
+
+        simTime += opt.dt;
+        ++frame;
+    }
+
+    util::logInfo("Replay finished: sim=" + std::to_string(simTime) + "s wall=" +
+        std::to_string(ms(Clock::now() - wallStart) / 1000.0) + "s");
+    util::logInfo("Frame timings: " + stats.summary());
+    if (!opt.csvPath.empty() && stats.writeCsv(opt.csvPath)) {
+        util::logInfo("Frame timings written to " + opt.csvPath);
     }
 }
 
 // 程序入口：初始化窗口与主循环
-int main() {
+int main(int argc, char** argv) {
+    App app;
+    ReplayOptions replayOpt;
+    if (!parseArgs(argc, argv, app, replayOpt)) {
+        return 1;
+    }
+
+    if (!vfs::mount(cfg::ASSET_PACK)) {
+#ifdef XIANGQI3D_LOOSE_ASSETS
+        util::logWarn("Asset pack not found, using loose files: " + cfg::ASSET_PACK);
+#else
+        util::logError("Failed to mount asset pack: " + cfg::ASSET_PACK);
+        return 1;
+#endif
+    }
+
+    ReplayScript script;
+    const bool replay = !replayOpt.scriptPath.empty();
+    if (replay && !script.load(replayOpt.scriptPath)) {
+        util::logError(script.error());
+        return 1;
+    }
+
     glfwSetErrorCallback(glfwErrorCallback);
 
+    if (replay && replayOpt.offscreen) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
     if (!glfwInit()) {
         util::logError("Failed to init GLFW");
         return 1;
@@ -299,8 +520,14 @@ int main() {
 #if defined(__APPLE__)
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
 #endif
+    if (replay) {
+        // 回放：隐藏窗口，关闭垂直同步；无窗口平台上改用 OSMesa（如 llvmpipe）
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        if (replayOpt.offscreen) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        }
+    }
 
-    App app;
     app.cam.target = glm::vec3(0.0f, 0.0f, 0.0f);
     app.cam.yawDeg = -90.0f;
     app.cam.pitchDeg = 52.0f;
@@ -314,10 +541,10 @@ int main() {
     }
 
     glfwMakeContextCurrent(app.window);
-    glfwSwapInterval(1);
-    
+    glfwSwapInterval(replay ? 0 : 1);
 
-    if (!gladLoadGL()) {
+    // 通过 GLFW 取函数地址，以便同样适用于 OSMesa/EGL 上下文
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         util::logError("Failed to load OpenGL via glad");
         glfwDestroyWindow(app.window);
         glfwTerminate();
@@ -343,56 +570,40 @@ int main() {
     app.w = fbw > 0 ? fbw : app.w;
     app.h = fbh > 0 ? fbh : app.h;
 
+    app.renderer.setShadowQuality(app.shadowSize, app.shadowKernel);
     if (!app.renderer.init(app.w, app.h)) {
         util::logError("Renderer init failed");
+        app.renderer.shutdown();
         glfwDestroyWindow(app.window);
         glfwTerminate();
         return 1;
     }
     app.renderer.beginPreload();
 
+    if (replay) {
+        runReplay(app, script, replayOpt);
+        app.renderer.shutdown();
+        glfwDestroyWindow(app.window);
+        glfwTerminate();
+        return 0;
+    }
+
     // 主循环：更新逻辑并按模式渲染
-double lastTime = glfwGetTime();
+    double lastTime = glfwGetTime();
     while (!glfwWindowShouldClose(app.window)) {
         double now = glfwGetTime();
         float dt = (float)(now - lastTime);
         lastTime = now;
 
-        if (app.mode == AppMode::Playing) {
-            app.game.update(dt);
-        }
-
-        updateWindowTitle(app.window, app.game, app.mode);
-        if (app.mode == AppMode::Menu) {
-            MenuLayout layout = makeMenuLayout(app.w, app.h);
-            double mx = 0.0, my = 0.0;
-            glfwGetCursorPos(app.window, &mx, &my);
-            float sx = (float)mx;
-            float sy = (float)app.h - (float)my;
-            bool hoverStart = pointInRect(sx, sy, layout.start);
-            bool hoverExit = pointInRect(sx, sy, layout.exit);
-            app.renderer.drawMenu(layout, hoverStart, hoverExit, true);
-        } else if (app.mode == AppMode::Loading) {
-            app.renderer.drawLoading(u8"\u6b63\u5728\u52a0\u8f7d\u8d44\u6e90\u002e\u002e\u002e\u002e\u002e\u002e");
-        } else {
-            app.renderer.draw(app.cam, app.game);
-        }
+        updateFrame(app, dt);
+        renderFrame(app);
 
         glfwSwapBuffers(app.window);
         glfwPollEvents();
-
-        if (!app.renderer.isPreloadReady()) {
-            app.renderer.preloadStep(1);
-        } else if (app.mode == AppMode::Loading) {
-            app.game.reset();
-            app.mode = AppMode::Playing;
-            if (!app.helpShown) {
-                app.game.startHelp(6.0f);
-                app.helpShown = true;
-            }
-        }
+        advancePreload(app);
     }
 
+    app.renderer.shutdown();
     glfwDestroyWindow(app.window);
     glfwTerminate();
     return 0;
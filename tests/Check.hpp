@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+
+// 最小断言：失败时打印位置并计数，不中断后续检查；main 以 checkResult() 作为返回值
+namespace check {
+
+inline int& failures() {
+    static int n = 0;
+    return n;
+}
+
+inline bool report(bool ok, const char* expr, const char* file, int line) {
+    if (!ok) {
+        std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, expr);
+        failures()++;
+    }
+    return ok;
+}
+
+inline int result(const char* name) {
+    if (failures()) std::fprintf(stderr, "%s: %d check(s) failed\n", name, failures());
+    else std::printf("%s: all checks passed\n", name);
+    return failures() ? 1 : 0;
+}
+
+} // namespace check
+
+#define CHECK(expr) check::report((expr), #expr, __FILE__, __LINE__)
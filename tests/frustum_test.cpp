@@ -0,0 +1,114 @@
+// Frustum 的 CPU 测试：随机包围盒与裁剪空间的暴力判定对照，SSE 与标量路径须一致
+
+#include "Check.hpp"
+#include "Frustum.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+// 盒子相对裁剪空间某一平面 (row3 ± rowi)·p >= 0 的最大值，按平面法线长度归一化（即世界空间距离）
+float maxPlaneDistance(const glm::mat4& clip, int plane, const BoxBounds& b) {
+    auto row = [&](int r) { return glm::vec4(clip[0][r], clip[1][r], clip[2][r], clip[3][r]); };
+    const int axis = plane / 2;
+    const glm::vec4 p = (plane % 2 == 0) ? row(3) + row(axis) : row(3) - row(axis);
+    const float len = glm::length(glm::vec3(p));
+    float best = -INFINITY;
+    for (int k = 0; k < 8; ++k) {
+        const glm::vec3 s((k & 1) ? 1.0f : -1.0f, (k & 2) ? 1.0f : -1.0f, (k & 4) ? 1.0f : -1.0f);
+        const glm::vec4 corner(b.center + s * b.extent, 1.0f);
+        best = std::max(best, glm::dot(p, corner) / len);
+    }
+    return best;
+}
+
+// 点是否严格位于视锥内（裁剪空间 -w < x,y,z < w）
+bool insideClip(const glm::mat4& clip, const glm::vec3& p, float margin) {
+    const glm::vec4 c = clip * glm::vec4(p, 1.0f);
+    const float w = c.w - margin;
+    return w > 0.0f && std::fabs(c.x) < w && std::fabs(c.y) < w && std::fabs(c.z) < w;
+}
+
+void testRandomBoxes() {
+    std::mt19937 rng(47);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    const float eps = 1e-3f; // 离判定边界这么近的盒子不比较，避免舍入带来的偶然差异
+
+    int culled = 0, visible = 0, mismatches = 0, falseCulls = 0, sseScalar = 0;
+    for (int view = 0; view < 50; ++view) {
+        const glm::vec3 eye(u(rng) * 10.0f, 2.0f + std::fabs(u(rng)) * 10.0f, u(rng) * 10.0f);
+        const glm::vec3 target(u(rng), u(rng), u(rng));
+        const glm::mat4 proj = view % 5 == 4
+            ? glm::ortho(-6.0f, 6.0f, -4.0f, 4.0f, 0.5f, 30.0f) // 阴影通道的正交光源视锥
+            : glm::perspective(glm::radians(30.0f + 40.0f * std::fabs(u(rng))), 1.0f + std::fabs(u(rng)), 0.1f, 40.0f);
+        const glm::mat4 clip = proj * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+        const Frustum frustum(clip);
+
+        for (int i = 0; i < 2000; ++i) {
+            BoxBounds b;
+            b.center = glm::vec3(u(rng), u(rng), u(rng)) * 20.0f;
+            b.extent = glm::abs(glm::vec3(u(rng), u(rng), u(rng))) * (i % 4 == 0 ? 0.05f : 2.0f);
+
+            const bool fast = frustum.intersects(b);
+            if (fast != frustum.intersectsScalar(b)) sseScalar++;
+
+            // 暴力判定：某一平面把 8 个角点全部排除在外即剔除
+            float separation = INFINITY;
+            for (int p = 0; p < 6; ++p) separation = std::min(separation, maxPlaneDistance(clip, p, b));
+            if (std::fabs(separation) > eps) {
+                const bool expected = separation > 0.0f;
+                if (fast != expected) mismatches++;
+                (expected ? visible : culled)++;
+            }
+
+            // 不误剔除：盒内任一采样点在视锥内，则必须判为相交
+            bool anyInside = insideClip(clip, b.center, eps);
+            for (int k = 0; k < 8 && !anyInside; ++k) {
+                const glm::vec3 s((k & 1) ? 1.0f : -1.0f, (k & 2) ? 1.0f : -1.0f, (k & 4) ? 1.0f : -1.0f);
+                anyInside = insideClip(clip, b.center + 0.999f * s * b.extent, eps);
+            }
+            if (anyInside && !fast) falseCulls++;
+        }
+    }
+    CHECK(sseScalar == 0);
+    CHECK(falseCulls == 0);
+    CHECK(mismatches == 0);
+    // 随机分布须同时覆盖两种结果
+    CHECK(culled > 1000);
+    CHECK(visible > 1000);
+}
+
+// transformBounds 的外包盒须包含变换后的 8 个角点
+void testTransformBounds() {
+    std::mt19937 rng(48);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    int escaped = 0;
+    for (int i = 0; i < 1000; ++i) {
+        AABB box;
+        box.min = glm::vec3(u(rng), u(rng), u(rng)) * 3.0f;
+        box.max = box.min + glm::abs(glm::vec3(u(rng), u(rng), u(rng))) * 2.0f;
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), glm::vec3(u(rng), u(rng), u(rng)) * 5.0f);
+        M = glm::rotate(M, u(rng) * 3.14159f, glm::normalize(glm::vec3(u(rng), u(rng), u(rng)) + glm::vec3(0.0f, 0.0f, 2.0f)));
+        M = glm::scale(M, glm::vec3(0.5f) + glm::abs(glm::vec3(u(rng), u(rng), u(rng))));
+
+        const BoxBounds b = transformBounds(box, M);
+        for (int k = 0; k < 8; ++k) {
+            const glm::vec3 corner((k & 1) ? box.max.x : box.min.x, (k & 2) ? box.max.y : box.min.y, (k & 4) ? box.max.z : box.min.z);
+            const glm::vec3 d = glm::abs(glm::vec3(M * glm::vec4(corner, 1.0f)) - b.center);
+            if (d.x > b.extent.x + 1e-4f || d.y > b.extent.y + 1e-4f || d.z > b.extent.z + 1e-4f) escaped++;
+        }
+    }
+    CHECK(escaped == 0);
+}
+
+} // namespace
+
+int main() {
+    testRandomBoxes();
+    testTransformBounds();
+    return check::result("frustum_test");
+}
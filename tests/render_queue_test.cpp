@@ -0,0 +1,175 @@
+// RenderQueue 的 CPU 测试：用记录执行器检查执行顺序与状态切换次数
+
+#include "Check.hpp"
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// 记录执行器：保存绘制顺序（payload 作为命令编号）并独立统计每种调用
+class RecordingExecutor : public RenderExecutor {
+public:
+    std::vector<uint32_t> drawn;
+    std::vector<RenderPass> drawnPass;
+    int begins = 0;
+    int ends = 0;
+    int shaderCalls = 0;
+    int textureCalls = 0;
+    int blendCalls = 0;
+    int depthCalls = 0;
+    int cullCalls = 0;
+    bool unbalanced = false;
+
+    void beginPass(RenderPass pass) override {
+        if (m_inPass) unbalanced = true;
+        m_inPass = true;
+        m_pass = pass;
+        begins++;
+    }
+    void endPass(RenderPass pass) override {
+        if (!m_inPass || pass != m_pass) unbalanced = true;
+        m_inPass = false;
+        ends++;
+    }
+    void setShader(uint8_t) override { shaderCalls++; }
+    void setTexture(uint32_t) override { textureCalls++; }
+    void setBlend(BlendMode) override { blendCalls++; }
+    void setDepth(bool, bool) override { depthCalls++; }
+    void setCull(CullMode) override { cullCalls++; }
+    void draw(const RenderCommand& cmd) override {
+        if (!m_inPass) unbalanced = true;
+        drawn.push_back(cmd.payload);
+        drawnPass.push_back(m_pass);
+    }
+
+private:
+    bool m_inPass = false;
+    RenderPass m_pass = RenderPass::Shadow;
+};
+
+RenderCommand command(uint32_t id, uint8_t shader, uint32_t texture, bool translucent = false) {
+    RenderCommand c;
+    c.payload = id;
+    c.state.shader = shader;
+    c.state.texture = texture;
+    c.state.depthWrite = !translucent;
+    return c;
+}
+
+struct Submission {
+    RenderPass pass;
+    bool ordered;
+    bool translucent;
+    float depth;
+    RenderCommand cmd;
+};
+
+// 跨通道混合提交的固定场景，逐条核对执行顺序与切换次数
+void testMixedPasses() {
+    const std::vector<Submission> subs = {
+        {RenderPass::Overlay, true, false, 0.0f, command(14, 5, 40)},
+        {RenderPass::Scene, false, false, 0.5f, command(1, 2, 20)},
+        {RenderPass::Background, true, false, 0.0f, command(12, 5, 50)},
+        {RenderPass::Scene, false, true, 0.2f, command(7, 3, 30, true)},
+        {RenderPass::Shadow, false, false, 0.7f, command(10, 4, 0)},
+        {RenderPass::Scene, false, false, 0.9f, command(2, 1, 10)},
+        {RenderPass::Scene, false, true, 0.8f, command(8, 3, 30, true)},
+        {RenderPass::Scene, false, false, 0.1f, command(3, 2, 10)},
+        {RenderPass::Overlay, true, false, 0.0f, command(15, 5, 40)},
+        {RenderPass::Scene, false, false, 0.2f, command(4, 1, 10)},
+        {RenderPass::Background, true, false, 0.0f, command(13, 5, 51)},
+        {RenderPass::Shadow, false, false, 0.3f, command(11, 4, 0)},
+        {RenderPass::Scene, false, true, 0.5f, command(9, 3, 31, true)},
+        {RenderPass::Scene, false, false, 0.3f, command(5, 1, 20)},
+        {RenderPass::Scene, false, false, 0.2f, command(6, 2, 20)},
+    };
+
+    RenderQueue queue;
+    for (const auto& s : subs) {
+        if (s.ordered) queue.submitOrdered(s.pass, s.cmd);
+        else queue.submit(s.pass, s.translucent, s.depth, s.cmd);
+    }
+    queue.sort();
+
+    RecordingExecutor exec;
+    RenderQueueStats stats = queue.execute(exec);
+
+    // 阴影：同状态近到远；背景/界面：提交顺序；场景：不透明按 着色器→纹理→近到远，半透明远到近
+    const std::vector<uint32_t> expected = {11, 10, 12, 13, 4, 2, 5, 3, 6, 1, 8, 9, 7, 14, 15};
+    CHECK(exec.drawn == expected);
+    CHECK(std::is_sorted(exec.drawnPass.begin(), exec.drawnPass.end()));
+    CHECK(!exec.unbalanced);
+
+    CHECK(stats.commands == 15);
+    CHECK(stats.passChanges == 4);
+    CHECK(exec.begins == 4 && exec.ends == 4);
+    // 每个通道开头重建一次状态；场景内着色器 1→2→3，纹理 10,10,20,10,20,20,30,31,30
+    CHECK(stats.shaderChanges == 1 + 1 + 3 + 1);
+    CHECK(stats.textureChanges == 1 + 2 + 7 + 1);
+    CHECK(stats.blendChanges == 4);
+    CHECK(stats.depthChanges == 1 + 1 + 2 + 1);
+    CHECK(stats.cullChanges == 4);
+
+    // 统计与执行器实际收到的调用一致
+    CHECK((int)stats.shaderChanges == exec.shaderCalls);
+    CHECK((int)stats.textureChanges == exec.textureCalls);
+    CHECK((int)stats.blendChanges == exec.blendCalls);
+    CHECK((int)stats.depthChanges == exec.depthCalls);
+    CHECK((int)stats.cullChanges == exec.cullCalls);
+}
+
+// 大量随机不透明命令：结果须与按（着色器、纹理、量化深度、提交序）的稳定排序一致，
+// 且每个着色器只切换一次、每个（着色器，纹理）组合只切换一次纹理
+void testRandomOpaque() {
+    std::mt19937 rng(7);
+    const uint32_t n = 3000; // 小于序号位宽（4096），序号不回绕
+    RenderQueue queue;
+    std::vector<std::tuple<uint8_t, uint32_t, uint32_t, uint32_t>> ref; // shader, texture, depth, id
+    std::set<uint8_t> shaders;
+    std::set<std::pair<uint8_t, uint32_t>> pairs;
+    for (uint32_t i = 0; i < n; ++i) {
+        uint8_t shader = (uint8_t)(rng() % 6);
+        uint32_t texture = 1 + rng() % 9;
+        float depth = (float)(rng() % 10000) / 9999.0f;
+        queue.submit(RenderPass::Scene, false, depth, command(i, shader, texture));
+        ref.emplace_back(shader, texture, sortkey::quantizeDepth(depth), i);
+        shaders.insert(shader);
+        pairs.insert({shader, texture});
+    }
+    queue.sort();
+    std::sort(ref.begin(), ref.end());
+
+    RecordingExecutor exec;
+    RenderQueueStats stats = queue.execute(exec);
+    CHECK(exec.drawn.size() == n);
+    bool same = exec.drawn.size() == ref.size();
+    for (size_t i = 0; same && i < ref.size(); ++i) same = exec.drawn[i] == std::get<3>(ref[i]);
+    CHECK(same);
+    CHECK(stats.shaderChanges == shaders.size());
+    CHECK(stats.textureChanges == pairs.size());
+    CHECK(stats.passChanges == 1);
+}
+
+// 空队列不开启任何通道
+void testEmpty() {
+    RenderQueue queue;
+    queue.sort();
+    RecordingExecutor exec;
+    RenderQueueStats stats = queue.execute(exec);
+    CHECK(stats.commands == 0 && exec.begins == 0 && exec.ends == 0);
+}
+
+} // namespace
+
+int main() {
+    testMixedPasses();
+    testRandomOpaque();
+    testEmpty();
+    return check::result("render_queue_test");
+}
@@ -0,0 +1,161 @@
+// VertexCodec 的 CPU 往返测试：打包后逐顶点解码，误差须在 MAX_* 界内，且与 pack 报告的误差一致
+
+#include "Check.hpp"
+#include "VertexCodec.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace vertexcodec;
+
+namespace {
+
+// 独立计算的往返误差（与 pack 内部的测量分开实现）
+PackError measure(const std::vector<VertexPN>& in, const std::vector<VertexPacked>& out, const VertexDequant& dq) {
+    PackError e;
+    glm::vec3 lo(INFINITY), hi(-INFINITY);
+    for (const auto& v : in) {
+        lo = glm::min(lo, v.pos);
+        hi = glm::max(hi, v.pos);
+    }
+    const glm::vec3 span = hi - lo;
+    const float extent = std::max(span.x, std::max(span.y, span.z));
+    for (size_t i = 0; i < in.size(); ++i) {
+        const VertexPN r = unpack(out[i], dq);
+        for (int a = 0; a < 3; ++a) {
+            if (extent > 0.0f) e.pos = std::max(e.pos, std::fabs(r.pos[a] - in[i].pos[a]) / extent);
+            else e.pos = std::max(e.pos, std::fabs(r.pos[a] - in[i].pos[a]));
+        }
+        const glm::vec3 a = glm::normalize(r.normal), b = glm::normalize(in[i].normal);
+        const float c = std::min(1.0f, std::max(-1.0f, glm::dot(a, b)));
+        e.normalDeg = std::max(e.normalDeg, std::acos(c) * 180.0f / glm::pi<float>());
+        e.uv = std::max(e.uv, std::max(std::fabs(r.uv.x - in[i].uv.x), std::fabs(r.uv.y - in[i].uv.y)));
+    }
+    return e;
+}
+
+struct Packed {
+    std::vector<VertexPacked> out;
+    VertexDequant dq;
+    PackError err;
+};
+
+Packed packAll(const std::vector<VertexPN>& in) {
+    Packed p;
+    p.out.resize(in.size());
+    pack(in.data(), in.size(), p.out.data(), p.dq, p.err);
+    return p;
+}
+
+// 独立测得的误差在界内，且不超过 pack 报告的值（报告值用于决定是否打包，不能偏乐观）
+void checkRoundTrip(const std::vector<VertexPN>& in, const Packed& p) {
+    const PackError e = measure(in, p.out, p.dq);
+    CHECK(p.err.withinBounds());
+    CHECK(e.pos <= MAX_POS_ERROR);
+    CHECK(e.normalDeg <= MAX_NORMAL_ERROR_DEG);
+    CHECK(e.uv <= MAX_UV_ERROR);
+    CHECK(e.pos <= p.err.pos + 1e-7f);
+    CHECK(e.normalDeg <= p.err.normalDeg + 1e-3f);
+    CHECK(e.uv <= p.err.uv + 1e-7f);
+}
+
+glm::vec3 randomUnit(std::mt19937& rng) {
+    std::normal_distribution<float> n(0.0f, 1.0f);
+    glm::vec3 v;
+    do {
+        v = glm::vec3(n(rng), n(rng), n(rng));
+    } while (glm::dot(v, v) < 1e-6f);
+    return glm::normalize(v);
+}
+
+// 一般网格：各轴跨度不同、偏离原点
+void testRandomMesh() {
+    std::mt19937 rng(45);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    std::vector<VertexPN> in(4096);
+    for (auto& v : in) {
+        v.pos = glm::vec3(-3.0f + 8.0f * u(rng), 10.0f + 0.25f * u(rng), -0.5f + 2.0f * u(rng));
+        v.normal = randomUnit(rng);
+        v.uv = glm::vec2(u(rng), u(rng));
+    }
+    checkRoundTrip(in, packAll(in));
+}
+
+// 退化轴：平面（z 跨度为 0）、线段（只有 x 变化）、所有顶点重合
+void testDegenerateExtents() {
+    std::mt19937 rng(46);
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+
+    std::vector<VertexPN> plane(256), line(64), point(8);
+    for (auto& v : plane) v = {{u(rng) * 2.0f, u(rng) * 3.0f, 1.25f}, {0.0f, 0.0f, 1.0f}, {u(rng), u(rng)}};
+    for (auto& v : line) v = {{u(rng) * 5.0f - 7.0f, -2.0f, 0.5f}, {0.0f, 1.0f, 0.0f}, {u(rng), 0.0f}};
+    for (auto& v : point) v = {{3.0f, -1.0f, 2.0f}, randomUnit(rng), {0.5f, 0.5f}};
+
+    Packed p = packAll(plane);
+    checkRoundTrip(plane, p);
+    CHECK(p.dq.scale.z == 0.0f);
+    bool exactZ = true;
+    for (const auto& q : p.out) exactZ = exactZ && unpack(q, p.dq).pos.z == 1.25f;
+    CHECK(exactZ);
+
+    p = packAll(line);
+    checkRoundTrip(line, p);
+    CHECK(p.dq.scale.y == 0.0f && p.dq.scale.z == 0.0f);
+
+    p = packAll(point);
+    checkRoundTrip(point, p);
+    CHECK(p.err.pos == 0.0f);
+    bool exact = true;
+    for (const auto& q : p.out) exact = exact && unpack(q, p.dq).pos == point[0].pos;
+    CHECK(exact);
+}
+
+// 零顶点网格：不读写任何顶点，误差为 0
+void testEmptyMesh() {
+    VertexDequant dq;
+    PackError err;
+    err.pos = err.normalDeg = err.uv = 1.0f;
+    pack(nullptr, 0, nullptr, dq, err);
+    CHECK(err.pos == 0.0f && err.normalDeg == 0.0f && err.uv == 0.0f);
+    CHECK(err.withinBounds());
+    CHECK(dq.offset == glm::vec3(0.0f) && dq.scale == glm::vec3(0.0f));
+}
+
+// 轴向法线（分量为 ±1）须精确还原，不被 10 位有符号归一化截断
+void testAxisNormals() {
+    const glm::vec3 axes[] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    std::vector<VertexPN> in;
+    for (int i = 0; i < 6; ++i) in.push_back({{(float)i, (float)(i % 2), 0.0f}, axes[i], {0.0f, 1.0f}});
+    Packed p = packAll(in);
+    checkRoundTrip(in, p);
+    CHECK(p.err.normalDeg == 0.0f);
+    bool exact = true;
+    for (size_t i = 0; i < in.size(); ++i) exact = exact && unpack(p.out[i], p.dq).normal == in[i].normal;
+    CHECK(exact);
+}
+
+// 超界数据须被报告出来：平铺 UV 的半精度误差远大于 MAX_UV_ERROR
+void testOutOfBoundsReported() {
+    std::vector<VertexPN> in = {
+        {{0, 0, 0}, {0, 0, 1}, {37.3f, 0.1f}},
+        {{1, 0, 0}, {0, 0, 1}, {-12.71f, 5.9f}},
+    };
+    Packed p = packAll(in);
+    CHECK(p.err.uv > MAX_UV_ERROR);
+    CHECK(!p.err.withinBounds());
+}
+
+} // namespace
+
+int main() {
+    testRandomMesh();
+    testDegenerateExtents();
+    testEmptyMesh();
+    testAxisNormals();
+    testOutOfBoundsReported();
+    return check::result("vertex_codec_test");
+}
@@ -0,0 +1,65 @@
+// 资源打包工具：把目录下的所有文件写入一个资源包
+//   asset_packer <dir> <out.pak> [--prefix assets/] [--no-compress]
+
+#include "AssetPack.hpp"
+#include "Util.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+    std::vector<std::string> positional;
+    std::string prefix = "assets/";
+    bool compress = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--prefix" && i + 1 < argc) prefix = argv[++i];
+        else if (arg == "--no-compress") compress = false;
+        else positional.push_back(arg);
+    }
+    if (positional.size() != 2) {
+        util::logError("Usage: asset_packer <dir> <out.pak> [--prefix assets/] [--no-compress]");
+        return 2;
+    }
+    if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+
+    const fs::path root = positional[0];
+    std::error_code ec;
+    std::vector<assetpack::PackInput> inputs;
+    size_t rawBytes = 0;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        assetpack::PackInput in;
+        in.name = prefix + fs::relative(it->path(), root, ec).generic_string();
+        in.mtime = (int64_t)fs::last_write_time(it->path(), ec).time_since_epoch().count();
+
+        std::ifstream file(it->path(), std::ios::binary);
+        if (!file) {
+            util::logError("Failed to open file: " + it->path().string());
+            return 1;
+        }
+        in.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        rawBytes += in.data.size();
+        inputs.push_back(std::move(in));
+    }
+    if (ec) {
+        util::logError("Failed to scan " + root.string() + ": " + ec.message());
+        return 1;
+    }
+
+    const size_t count = inputs.size();
+    std::string error;
+    if (!assetpack::writePack(positional[1], std::move(inputs), compress, &error)) {
+        util::logError(error);
+        return 1;
+    }
+    util::logInfo("Wrote asset pack: " + positional[1] + " (" + std::to_string(count) + " files, " +
+                  std::to_string(rawBytes / 1024) + " KB raw, " +
+                  std::to_string((size_t)fs::file_size(positional[1], ec) / 1024) + " KB packed)");
+    return 0;
+}